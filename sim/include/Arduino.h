@@ -0,0 +1,196 @@
+#pragma once
+
+// Host stand-in for the slice of the Arduino-ESP32 core used by AuroraCharm.
+// Only what main.cpp, bleControl.h and src/programs actually touch lives here;
+// everything FastLED-related comes from the real FastLED library (stub platform).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+#define INPUT_PULLDOWN  0x09
+
+// XIAO ESP32-S3 pin aliases
+#define D0  1
+#define D1  2
+#define D2  3
+#define D3  4
+#define D4  5
+#define D5  6
+#define D6  43
+#define D7  44
+#define D8  7
+#define D9  8
+#define D10 9
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_ptr
+#define pgm_read_ptr(addr) (*(const void* const*)(addr))
+#endif
+#ifndef strcpy_P
+#define strcpy_P(dest, src) strcpy((dest), (src))
+#endif
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+// Time ***************************************************************************
+// Backed by the simulated clock in simHost.cpp, so every run is reproducible.
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+// ESP ****************************************************************************
+// Cycle counter for the frame profiler; runs off the host clock at a nominal 240 MHz.
+
+class EspClass {
+  public:
+	uint32_t getCycleCount();
+	uint32_t getCpuFreqMHz() { return 240; }
+};
+
+extern EspClass ESP;
+
+// GPIO / random ******************************************************************
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// String *************************************************************************
+
+class String {
+  public:
+	String() {}
+	String(const char* s) : str(s ? s : "") {}
+	String(const char* s, size_t n) : str(s ? s : "", s ? n : 0) {}
+	String(const std::string& s) : str(s) {}
+	String(char c) : str(1, c) {}
+	String(unsigned char v) : str(std::to_string(v)) {}
+	String(int v) : str(std::to_string(v)) {}
+	String(unsigned int v) : str(std::to_string(v)) {}
+	String(long v) : str(std::to_string(v)) {}
+	String(unsigned long v) : str(std::to_string(v)) {}
+	String(float v, unsigned int decimals = 2) : str(formatFloat(v, decimals)) {}
+	String(double v, unsigned int decimals = 2) : str(formatFloat(v, decimals)) {}
+
+	const char* c_str() const { return str.c_str(); }
+	unsigned int length() const { return str.length(); }
+	bool reserve(unsigned int size) { str.reserve(size); return true; }
+
+	char operator[](unsigned int i) const { return i < str.length() ? str[i] : 0; }
+	char& operator[](unsigned int i) { return str[i]; }
+
+	bool equals(const String& s) const { return str == s.str; }
+	bool equals(const char* s) const { return str == (s ? s : ""); }
+	bool operator==(const String& s) const { return equals(s); }
+	bool operator==(const char* s) const { return equals(s); }
+	bool operator!=(const String& s) const { return !equals(s); }
+	bool operator!=(const char* s) const { return !equals(s); }
+
+	bool concat(const String& s) { str += s.str; return true; }
+	bool concat(const char* s) { if (s) str += s; return true; }
+	bool concat(const char* s, unsigned int n) { if (s) str.append(s, n); return true; }
+	bool concat(char c) { str += c; return true; }
+
+	template <typename T>
+	String& operator+=(const T& v) { concat(String(v)); return *this; }
+	String& operator+=(const char* s) { concat(s); return *this; }
+
+	friend String operator+(const String& a, const String& b) { String r(a); r.concat(b); return r; }
+
+  private:
+	static std::string formatFloat(double v, unsigned int decimals) {
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+		return buf;
+	}
+
+	std::string str;
+};
+
+// Print / Stream / Serial ********************************************************
+
+class Print {
+  public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size) {
+		size_t n = 0;
+		while (size--) n += write(*buffer++);
+		return n;
+	}
+	size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+
+	size_t print(const char* s) { return write(s); }
+	size_t print(const String& s) { return write(s.c_str()); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(unsigned char v) { return print(String(v)); }
+	size_t print(int v) { return print(String(v)); }
+	size_t print(unsigned int v) { return print(String(v)); }
+	size_t print(long v) { return print(String(v)); }
+	size_t print(unsigned long v) { return print(String(v)); }
+	size_t print(double v, int decimals = 2) { return print(String(v, decimals)); }
+
+	template <typename T>
+	size_t println(const T& v) { size_t n = print(v); return n + println(); }
+	size_t println() { return write((uint8_t)'\n'); }
+};
+
+class Stream : public Print {
+  public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+	size_t readBytes(char* buffer, size_t length) {
+		size_t n = 0;
+		while (n < length) {
+			int c = read();
+			if (c < 0) break;
+			buffer[n++] = (char)c;
+		}
+		return n;
+	}
+	size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+};
+
+class HardwareSerial : public Stream {
+  public:
+	using Print::write;
+	void begin(unsigned long baud) { (void)baud; }
+	size_t write(uint8_t c) override { fputc(c, stdout); return 1; }
+	size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, stdout); }
+	int available() override { return 0; }
+	int read() override { return -1; }
+	int peek() override { return -1; }
+	operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
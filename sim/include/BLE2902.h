@@ -0,0 +1,8 @@
+#pragma once
+
+#include "BLEDevice.h"
+
+class BLE2902 : public BLEDescriptor {
+  public:
+	BLE2902() : BLEDescriptor(BLEUUID((uint16_t)0x2902)) {}
+};
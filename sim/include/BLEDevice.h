@@ -0,0 +1,147 @@
+#pragma once
+
+// Host stand-in for the ESP32 Bluedroid BLE API. There is no radio: the
+// simulation drives writes through BLECharacteristic::simWrite(), which runs
+// the same onWrite() callbacks a phone would trigger, and keeps the last value
+// each characteristic notified so tools can inspect replies.
+
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+typedef enum { ESP_BLE_PWR_TYPE_CONN_HDL0 = 0, ESP_BLE_PWR_TYPE_ADV = 9, ESP_BLE_PWR_TYPE_DEFAULT = 11 } esp_ble_power_type_t;
+typedef enum { ESP_PWR_LVL_N12 = 0, ESP_PWR_LVL_N9, ESP_PWR_LVL_N6, ESP_PWR_LVL_N3, ESP_PWR_LVL_N0, ESP_PWR_LVL_P3, ESP_PWR_LVL_P6, ESP_PWR_LVL_P9 } esp_power_level_t;
+
+inline int esp_ble_tx_power_set(esp_ble_power_type_t, esp_power_level_t) { return 0; }
+
+class BLEServer;
+class BLECharacteristic;
+
+class BLEUUID {
+  public:
+	BLEUUID() {}
+	BLEUUID(uint16_t uuid16) : uuid(String((unsigned int)uuid16)) {}
+	BLEUUID(const char* uuid) : uuid(uuid) {}
+	String toString() const { return uuid; }
+
+  private:
+	String uuid;
+};
+
+class BLEDescriptor {
+  public:
+	BLEDescriptor(BLEUUID uuid) : uuid(uuid) {}
+	virtual ~BLEDescriptor() {}
+
+  private:
+	BLEUUID uuid;
+};
+
+class BLECharacteristicCallbacks {
+  public:
+	virtual ~BLECharacteristicCallbacks() {}
+	virtual void onRead(BLECharacteristic* characteristic) { (void)characteristic; }
+	virtual void onWrite(BLECharacteristic* characteristic) { (void)characteristic; }
+};
+
+class BLECharacteristic {
+  public:
+	static const uint32_t PROPERTY_READ = 1 << 0;
+	static const uint32_t PROPERTY_WRITE = 1 << 1;
+	static const uint32_t PROPERTY_NOTIFY = 1 << 2;
+	static const uint32_t PROPERTY_BROADCAST = 1 << 3;
+	static const uint32_t PROPERTY_INDICATE = 1 << 4;
+	static const uint32_t PROPERTY_WRITE_NR = 1 << 5;
+
+	BLECharacteristic(const char* uuid, uint32_t properties) : uuid(uuid), properties(properties) {}
+
+	void setCallbacks(BLECharacteristicCallbacks* cb) { callbacks = cb; }
+	void addDescriptor(BLEDescriptor* descriptor) { descriptors.push_back(descriptor); }
+	void setValue(const String& v) { value = v; }
+	void setValue(const uint8_t* data, size_t size) { value = String((const char*)data, size); }
+	String getValue() { return value; }
+	BLEUUID getUUID() { return uuid; }
+
+	void notify() {
+		lastNotified = value;
+		notifyCount++;
+	}
+
+	// Simulation hook: behave as if a central wrote this value.
+	void simWrite(const String& v) {
+		value = v;
+		if (callbacks) callbacks->onWrite(this);
+	}
+	void simWrite(const uint8_t* data, size_t size) { simWrite(String((const char*)data, size)); }
+
+	String lastNotified;
+	uint32_t notifyCount = 0;
+
+  private:
+	BLEUUID uuid;
+	uint32_t properties;
+	BLECharacteristicCallbacks* callbacks = nullptr;
+	std::vector<BLEDescriptor*> descriptors;
+	String value;
+};
+
+class BLEService {
+  public:
+	BLECharacteristic* createCharacteristic(const char* uuid, uint32_t properties) {
+		BLECharacteristic* c = new BLECharacteristic(uuid, properties);
+		registry()[uuid] = c;
+		return c;
+	}
+	void start() {}
+
+	static BLECharacteristic* findCharacteristic(const char* uuid) {
+		auto it = registry().find(uuid);
+		return it == registry().end() ? nullptr : it->second;
+	}
+
+  private:
+	static std::map<std::string, BLECharacteristic*>& registry() {
+		static std::map<std::string, BLECharacteristic*> characteristics;
+		return characteristics;
+	}
+};
+
+class BLEServerCallbacks {
+  public:
+	virtual ~BLEServerCallbacks() {}
+	virtual void onConnect(BLEServer* server) { (void)server; }
+	virtual void onDisconnect(BLEServer* server) { (void)server; }
+};
+
+class BLEServer {
+  public:
+	void setCallbacks(BLEServerCallbacks* cb) { callbacks = cb; }
+	BLEServerCallbacks* getCallbacks() { return callbacks; }
+	BLEService* createService(const char* uuid) { (void)uuid; return new BLEService(); }
+	void startAdvertising() {}
+
+  private:
+	BLEServerCallbacks* callbacks = nullptr;
+};
+
+class BLEAdvertising {
+  public:
+	void addServiceUUID(const char* uuid) { (void)uuid; }
+	void setScanResponse(bool enable) { (void)enable; }
+	void setMinPreferred(uint16_t interval) { (void)interval; }
+	void start() {}
+};
+
+class BLEDevice {
+  public:
+	static void init(String deviceName) { (void)deviceName; }
+	static BLEServer* createServer() {
+		static BLEServer server;
+		return &server;
+	}
+	static BLEAdvertising* getAdvertising() {
+		static BLEAdvertising advertising;
+		return &advertising;
+	}
+	static void startAdvertising() {}
+};
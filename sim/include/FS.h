@@ -0,0 +1,79 @@
+#pragma once
+
+// Host stand-in for the Arduino-ESP32 filesystem API. Files live in memory for
+// the lifetime of the process; presets saved by one program run are visible to
+// later ones within the same simulation.
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+	class File : public Stream {
+	  public:
+		using Print::write;
+
+		File() {}
+		File(std::shared_ptr<std::string> data, const char* mode, const char* path)
+			: data(data), path(path), writable(mode[0] != 'r') {}
+
+		size_t write(uint8_t c) override {
+			if (!data || !writable) return 0;
+			data->push_back((char)c);
+			return 1;
+		}
+		size_t write(const uint8_t* buffer, size_t size) override {
+			if (!data || !writable) return 0;
+			data->append((const char*)buffer, size);
+			return size;
+		}
+		int available() override { return data ? (int)(data->size() - pos) : 0; }
+		int read() override { return available() > 0 ? (uint8_t)(*data)[pos++] : -1; }
+		int peek() override { return available() > 0 ? (uint8_t)(*data)[pos] : -1; }
+		size_t size() const { return data ? data->size() : 0; }
+		const char* name() const { return path.c_str(); }
+		void close() { data.reset(); }
+		operator bool() const { return (bool)data; }
+
+	  private:
+		std::shared_ptr<std::string> data;
+		std::string path;
+		size_t pos = 0;
+		bool writable = false;
+	};
+
+	class FS {
+	  public:
+		File open(const char* path, const char* mode = FILE_READ, bool create = false) {
+			(void)create;
+			auto it = files.find(path);
+			if (mode[0] == 'r') {
+				if (it == files.end()) return File();
+				return File(it->second, mode, path);
+			}
+			if (it == files.end() || mode[0] == 'w') {
+				files[path] = std::make_shared<std::string>();
+			}
+			return File(files[path], mode, path);
+		}
+		File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+			return open(path.c_str(), mode, create);
+		}
+		bool exists(const char* path) { return files.count(path) > 0; }
+		bool exists(const String& path) { return exists(path.c_str()); }
+		bool remove(const char* path) { return files.erase(path) > 0; }
+		bool remove(const String& path) { return remove(path.c_str()); }
+
+	  private:
+		std::map<std::string, std::shared_ptr<std::string>> files;
+	};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
@@ -0,0 +1,35 @@
+#pragma once
+
+// Host stand-in for the ESP32 NVS Preferences API (in-memory, per namespace).
+
+#include <Arduino.h>
+#include <map>
+
+class Preferences {
+  public:
+	bool begin(const char* name, bool readOnly = false) {
+		space = name;
+		this->readOnly = readOnly;
+		return true;
+	}
+	void end() { space.clear(); }
+
+	uint8_t getUChar(const char* key, uint8_t defaultValue = 0) {
+		auto it = store()[space].find(key);
+		return it == store()[space].end() ? defaultValue : it->second;
+	}
+	size_t putUChar(const char* key, uint8_t value) {
+		if (readOnly) return 0;
+		store()[space][key] = value;
+		return 1;
+	}
+
+  private:
+	static std::map<std::string, std::map<std::string, uint8_t>>& store() {
+		static std::map<std::string, std::map<std::string, uint8_t>> nvs;
+		return nvs;
+	}
+
+	std::string space;
+	bool readOnly = false;
+};
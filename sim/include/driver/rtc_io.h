@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF RTC GPIO / deep sleep calls used by shutdownCheck().
+
+#include <stdint.h>
+
+typedef int gpio_num_t;
+
+typedef enum {
+	ESP_EXT1_WAKEUP_ANY_LOW = 0,
+	ESP_EXT1_WAKEUP_ANY_HIGH = 1
+} esp_sleep_ext1_wakeup_mode_t;
+
+inline int rtc_gpio_pulldown_en(gpio_num_t) { return 0; }
+inline int rtc_gpio_pullup_dis(gpio_num_t) { return 0; }
+inline int esp_sleep_enable_ext1_wakeup_io(uint64_t, esp_sleep_ext1_wakeup_mode_t) { return 0; }
+void esp_deep_sleep_start();
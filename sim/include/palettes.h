@@ -0,0 +1,52 @@
+#pragma once
+
+// Host stand-in for the shared gradient palette collection that the device build
+// pulls from the PlatformIO template directory. A handful of the same gradients
+// is enough to exercise the waves palette rotation.
+
+#include <FastLED.h>
+
+DEFINE_GRADIENT_PALETTE( Sunset_Real_gp ) {
+	  0, 120,  0,  0,
+	 22, 179, 22,  0,
+	 51, 255,104,  0,
+	 85, 167, 22, 18,
+	135, 100,  0,103,
+	198,  16,  0,130,
+	255,   0,  0,160};
+
+DEFINE_GRADIENT_PALETTE( es_ocean_breeze_036_gp ) {
+	  0,   1,  6,  7,
+	 89,   1, 99,111,
+	153, 144,209,255,
+	255,   0, 73, 82};
+
+DEFINE_GRADIENT_PALETTE( rgi_15_gp ) {
+	  0,   4,  1, 31,
+	 31,  55,  1, 16,
+	 63, 197,  3,  7,
+	 95,  59,  2, 17,
+	127,   6,  2, 34,
+	159,  39,  6, 33,
+	191, 112, 13, 32,
+	223,  56,  9, 35,
+	255,  22,  6, 38};
+
+DEFINE_GRADIENT_PALETTE( Magenta_Evening_gp ) {
+	  0,  71, 27, 39,
+	 31, 130, 11, 51,
+	 63, 213,  2, 64,
+	 70, 232,  1, 66,
+	 76, 252,  1, 69,
+	108, 123,  2, 51,
+	255,  46,  9, 35};
+
+const TProgmemRGBGradientPaletteRef gGradientPalettes[] = {
+	Sunset_Real_gp,
+	es_ocean_breeze_036_gp,
+	rgi_15_gp,
+	Magenta_Evening_gp
+};
+
+const uint8_t gGradientPaletteCount =
+	sizeof( gGradientPalettes) / sizeof( TProgmemRGBGradientPaletteRef );
@@ -0,0 +1,86 @@
+#pragma once
+
+// Host simulation API shared by the native runners in sim/.
+// main.cpp only sees this header when built with AURORA_SIM.
+
+#include <FastLED.h>
+#include <BLEDevice.h>
+
+namespace sim {
+
+	// Simulated clock ***************************************************************
+	// millis()/micros()/delay() read and advance this; nothing in the firmware sees
+	// host wall-clock time, so a run is fully determined by the timestamps fed in.
+
+	void setMillis(uint32_t ms);
+	void advanceMillis(uint32_t ms);
+	uint32_t nowMillis();
+
+	// Output ************************************************************************
+	// Stands in for the WS2812B strip. FastLED.show() lands here with brightness,
+	// colour correction and dithering applied, exactly as it would reach the wire.
+
+	class OutputController : public CPixelLEDController<RGB> {
+	  public:
+		void init() override {}
+		void showPixels(PixelController<RGB>& pixels) override;
+
+		const uint8_t* framebuffer() const { return frame; }
+		uint16_t size() const { return frameSize; }
+		uint32_t showCount() const { return shows; }
+		uint64_t outputNanos() const { return nanos; }   // wall time spent in showPixels()
+		void resetCounters() { shows = 0; nanos = 0; }
+
+	  private:
+		static const uint16_t MAX_PIXELS = 1024;
+		uint8_t frame[MAX_PIXELS * 3] = {0};
+		uint16_t frameSize = 0;
+		uint32_t shows = 0;
+		uint64_t nanos = 0;
+	};
+
+	OutputController& output();
+
+	// Set before setup() to run the render pipeline's output side on its own
+	// std::thread, as it runs on its own core on the device. Off by default:
+	// inline output keeps show counts and hashes reproducible.
+	void setThreadedOutput(bool threaded);
+	bool threadedOutput();
+
+	// BLE ***************************************************************************
+	// Writes go through the real characteristic callbacks in bleControl.h.
+
+	void bleConnect();
+	void bleDisconnect();
+	void bleButton(uint8_t value);
+	void bleNumber(const char* id, float value);
+	// Binary number frame (processNumberFrame); the tag byte is added here
+	void bleNumbers(const uint8_t* ids, const float* values, size_t count);
+	void bleCheckbox(const char* id, bool value);
+	String bleLastString();   // last notification on the string characteristic
+
+	// Noise accuracy ****************************************************************
+	// While enabled, ANIMartRIX::render_layers() re-evaluates every layer look-up
+	// with pnoise_q16() and the float reference and accumulates the difference here.
+
+	struct NoiseError {
+		bool enabled = false;
+		uint32_t samples = 0;
+		double maxAbs = 0, sumAbs = 0;   // raw noise units
+		double maxLevels = 0;            // after scale_noise(), in 0-255 levels
+		float minCoord = 0, maxCoord = 0;
+
+		void reset() { *this = NoiseError{enabled}; }
+	};
+
+	NoiseError& noiseError();
+
+	// Largest |pnoise_q16 - pnoise_float| accepted, in raw noise units. The sweep
+	// in sim/simNoiseCheck.cpp measures 1.68e-4, 1.83e-4 next to cell edges.
+	constexpr double NOISE_Q16_MAX_ERROR = 2.0e-4;
+
+	// Helpers ***********************************************************************
+
+	uint32_t frameHash(const uint8_t* data, size_t size);   // FNV-1a
+
+} // namespace sim
@@ -0,0 +1,9 @@
+# PlatformIO extra script for env:native_asan / env:native_tsan: sanitizers need the
+# flags at link time too.
+Import("env")
+
+if env["PIOENV"] == "native_tsan":
+    flags = ["-fsanitize=thread", "-fno-omit-frame-pointer"]
+else:
+    flags = ["-fsanitize=address,undefined", "-fno-omit-frame-pointer"]
+env.Append(CCFLAGS=flags, LINKFLAGS=flags)
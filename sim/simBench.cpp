@@ -0,0 +1,170 @@
+// Frame-time benchmark: drives every PROGRAM case of loop() and every
+// Animartrix mode for N frames at fixed simulated timestamps and reports
+// per-frame wall time (min / median / p99), pixel throughput and how the
+// frame splits between rendering and the output stage (FastLED.show()).
+//
+//   .pio/build/native_bench/program [--frames N] [--warmup N] [--step MS]
+//                                   [--program P] [--mode M] [--format csv|json]
+//                                   [--noise-accuracy] [--threaded]
+//
+// --threaded runs FastLED.show() on the render pipeline's output thread, as on
+// the device; frame times then only include the hand-off, not the output.
+//
+// --noise-accuracy instead reports, per Animartrix mode, how far the Q16 noise
+// pipeline (pnoise_q16) strays from the float reference at every coordinate the
+// effect samples during the run. Exits 1 if any mode exceeds
+// sim::NOISE_Q16_MAX_ERROR; env:native_noise checks the same bound on a sweep.
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "simHost.h"
+
+void setup();
+void loop();
+
+extern const uint16_t simNumLeds;
+extern const uint8_t simProgramCount;
+extern const uint8_t* const simModeCounts;
+String simVisualizerName(uint8_t program, uint8_t mode);
+void simFlushOutput();
+
+struct BenchResult {
+	String name;
+	uint8_t program, mode;
+	int frames;
+	double minUs, medianUs, p99Us, meanUs;
+	double renderUs, outputUs;   // mean per frame
+	double pixelsPerSec;
+	sim::NoiseError noise;
+};
+
+static double percentile(const std::vector<double>& sorted, double p) {
+	if (sorted.empty()) return 0;
+	size_t idx = (size_t)(p * (sorted.size() - 1) + 0.5);
+	return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+static BenchResult runBench(uint8_t program, uint8_t mode, int warmup, int frames, int step) {
+	sim::bleButton(program);
+	if (simModeCounts[program]) sim::bleButton(20 + mode);
+
+	for (int f = 0; f < warmup; f++) {
+		sim::advanceMillis(step);
+		loop();
+	}
+
+	std::vector<double> frameUs;
+	frameUs.reserve(frames);
+	double totalUs = 0;
+	simFlushOutput();
+	sim::output().resetCounters();
+	sim::noiseError().reset();
+
+	for (int f = 0; f < frames; f++) {
+		sim::advanceMillis(step);
+		auto start = std::chrono::steady_clock::now();
+		loop();
+		double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+		frameUs.push_back(us);
+		totalUs += us;
+	}
+
+	simFlushOutput();
+	double outputUs = sim::output().outputNanos() / 1000.0;
+
+	BenchResult r;
+	r.name = simVisualizerName(program, mode);
+	r.program = program;
+	r.mode = mode;
+	r.frames = frames;
+	std::sort(frameUs.begin(), frameUs.end());
+	r.minUs = frameUs.front();
+	r.medianUs = percentile(frameUs, 0.5);
+	r.p99Us = percentile(frameUs, 0.99);
+	r.meanUs = totalUs / frames;
+	r.outputUs = outputUs / frames;
+	// with a threaded output the show overlaps the next frame instead of adding to it
+	r.renderUs = sim::threadedOutput() ? r.meanUs : r.meanUs - r.outputUs;
+	r.pixelsPerSec = totalUs > 0 ? (double)simNumLeds * frames / (totalUs / 1e6) : 0;
+	r.noise = sim::noiseError();
+	return r;
+}
+
+int main(int argc, char** argv) {
+	int frames = 500;
+	int warmup = 50;
+	int step = 16;
+	int onlyProgram = -1;
+	int onlyMode = -1;
+	bool json = false;
+	bool noiseAccuracy = false;
+
+	for (int i = 1; i < argc; i++) {
+		String arg = argv[i];
+		const char* next = i + 1 < argc ? argv[i + 1] : "0";
+		if (arg == "--frames") { frames = std::max(1, atoi(next)); i++; }
+		else if (arg == "--warmup") { warmup = atoi(next); i++; }
+		else if (arg == "--step") { step = atoi(next); i++; }
+		else if (arg == "--program") { onlyProgram = atoi(next); i++; }
+		else if (arg == "--mode") { onlyMode = atoi(next); i++; }
+		else if (arg == "--format") { json = String(next) == "json"; i++; }
+		else if (arg == "--noise-accuracy") { noiseAccuracy = true; }
+		else if (arg == "--threaded") { sim::setThreadedOutput(true); }
+		else {
+			fprintf(stderr, "usage: %s [--frames N] [--warmup N] [--step MS] [--program P] [--mode M] [--format csv|json] [--noise-accuracy] [--threaded]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	sim::noiseError().enabled = noiseAccuracy;
+
+	setup();
+	sim::bleConnect();
+	sim::bleNumber("inBright", 255);
+
+	std::vector<BenchResult> results;
+	for (uint8_t program = 0; program < simProgramCount; program++) {
+		if (onlyProgram >= 0 && program != onlyProgram) continue;
+		uint8_t modes = simModeCounts[program] ? simModeCounts[program] : 1;
+		for (uint8_t mode = 0; mode < modes; mode++) {
+			if (onlyMode >= 0 && mode != onlyMode) continue;
+			results.push_back(runBench(program, mode, warmup, frames, step));
+		}
+	}
+
+	if (noiseAccuracy) {
+		bool ok = true;
+		printf("name,program,mode,samples,max_abs_error,mean_abs_error,max_level_error,coord_min,coord_max\n");
+		for (const BenchResult& r : results) {
+			const sim::NoiseError& n = r.noise;
+			if (!n.samples) continue;   // not an Animartrix mode
+			printf("%s,%u,%u,%u,%.7f,%.7f,%.3f,%.1f,%.1f\n",
+				   r.name.c_str(), r.program, r.mode, n.samples, n.maxAbs, n.sumAbs / n.samples,
+				   n.maxLevels, n.minCoord, n.maxCoord);
+			if (n.maxAbs > sim::NOISE_Q16_MAX_ERROR) ok = false;
+		}
+		return ok ? 0 : 1;
+	}
+
+	if (json) {
+		printf("{\"leds\":%u,\"frames\":%d,\"stepMs\":%d,\"results\":[\n", simNumLeds, frames, step);
+		for (size_t i = 0; i < results.size(); i++) {
+			const BenchResult& r = results[i];
+			printf("  {\"name\":\"%s\",\"program\":%u,\"mode\":%u,\"minUs\":%.2f,\"medianUs\":%.2f,"
+				   "\"p99Us\":%.2f,\"renderUs\":%.2f,\"outputUs\":%.2f,\"pixelsPerSec\":%.0f}%s\n",
+				   r.name.c_str(), r.program, r.mode, r.minUs, r.medianUs, r.p99Us,
+				   r.renderUs, r.outputUs, r.pixelsPerSec, i + 1 < results.size() ? "," : "");
+		}
+		printf("]}\n");
+	} else {
+		printf("name,program,mode,frames,min_us,median_us,p99_us,render_us,output_us,pixels_per_sec\n");
+		for (const BenchResult& r : results) {
+			printf("%s,%u,%u,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f\n",
+				   r.name.c_str(), r.program, r.mode, r.frames, r.minUs, r.medianUs, r.p99Us,
+				   r.renderUs, r.outputUs, r.pixelsPerSec);
+		}
+	}
+	return 0;
+}
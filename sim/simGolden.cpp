@@ -0,0 +1,229 @@
+// Golden-frame recorder / comparator. Renders every program and mode at fixed
+// simulated timestamps and either stores the LED colours (in chain order, as
+// sent to the strip) at the capture points or compares them against a
+// previously recorded file, reporting the worst per-channel difference and
+// PSNR for each run. Used to measure the visual drift of optimisations
+// (fast-math, fixed-point noise, trig tables...) instead of eyeballing a pendant.
+//
+//   .pio/build/native_golden/program record  golden.bin [--frames N] [--step MS] [--every N]
+//   .pio/build/native_golden/program compare golden.bin [--tolerance N] [--min-psnr DB]
+//
+// File layout (little endian):
+//   "ACGF" u16 version u16 numLeds u16 runs u16 frames u16 stepMs u16 every
+//   per run:     u8 program, u8 mode
+//     per capture: u32 timestamp, numLeds * 3 bytes RGB
+
+#include <Arduino.h>
+#include <math.h>
+#include <vector>
+#include "frameClock.h"
+#include "simHost.h"
+
+void setup();
+void loop();
+
+extern CRGB leds[];
+void simChainLeds(uint8_t* rgb);
+extern FrameClock frameClock;
+extern const uint16_t simNumLeds;
+extern const uint8_t simProgramCount;
+extern const uint8_t* const simModeCounts;
+String simVisualizerName(uint8_t program, uint8_t mode);
+
+static const char GOLDEN_MAGIC[4] = {'A', 'C', 'G', 'F'};
+static const uint16_t GOLDEN_VERSION = 1;
+static const uint32_t GOLDEN_START_MS = 100000;
+
+struct GoldenHeader {
+	uint16_t numLeds, runs, frames, stepMs, every;
+};
+
+struct Capture {
+	uint32_t timestamp;
+	std::vector<uint8_t> rgb;
+};
+
+struct Run {
+	uint8_t program, mode;
+	std::vector<Capture> captures;
+};
+
+// Rendering ***********************************************************************
+
+static void startRun(uint8_t program, uint8_t mode) {
+	sim::bleButton(program);
+	if (simModeCounts[program]) sim::bleButton(20 + mode);
+
+	// every run starts from the same clock, seed and blank canvas
+	sim::setMillis(GOLDEN_START_MS);
+	frameClock = FrameClock();
+	randomSeed(1);
+	random16_set_seed(1337);
+	fill_solid(leds, simNumLeds, CRGB::Black);
+}
+
+static std::vector<Run> renderAll(const GoldenHeader& h) {
+	std::vector<Run> runs;
+	for (uint8_t program = 0; program < simProgramCount; program++) {
+		uint8_t modes = simModeCounts[program] ? simModeCounts[program] : 1;
+		for (uint8_t mode = 0; mode < modes; mode++) {
+			Run run{program, mode, {}};
+			startRun(program, mode);
+			for (int f = 1; f <= h.frames; f++) {
+				sim::advanceMillis(h.stepMs);
+				loop();
+				if (f % h.every == 0) {
+					Capture c;
+					c.timestamp = sim::nowMillis();
+					c.rgb.resize(simNumLeds * 3);
+					simChainLeds(c.rgb.data());
+					run.captures.push_back(c);
+				}
+			}
+			runs.push_back(run);
+		}
+	}
+	return runs;
+}
+
+// File I/O ************************************************************************
+
+static void put16(FILE* f, uint16_t v) { uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)}; fwrite(b, 1, 2, f); }
+static void put32(FILE* f, uint32_t v) { put16(f, v & 0xFFFF); put16(f, v >> 16); }
+static bool get16(FILE* f, uint16_t& v) { uint8_t b[2]; if (fread(b, 1, 2, f) != 2) return false; v = b[0] | (b[1] << 8); return true; }
+static bool get32(FILE* f, uint32_t& v) { uint16_t lo, hi; if (!get16(f, lo) || !get16(f, hi)) return false; v = lo | ((uint32_t)hi << 16); return true; }
+
+static bool writeGolden(const char* path, const GoldenHeader& h, const std::vector<Run>& runs) {
+	FILE* f = fopen(path, "wb");
+	if (!f) return false;
+	fwrite(GOLDEN_MAGIC, 1, 4, f);
+	put16(f, GOLDEN_VERSION);
+	put16(f, h.numLeds);
+	put16(f, (uint16_t)runs.size());
+	put16(f, h.frames);
+	put16(f, h.stepMs);
+	put16(f, h.every);
+	for (const Run& run : runs) {
+		fputc(run.program, f);
+		fputc(run.mode, f);
+		for (const Capture& c : run.captures) {
+			put32(f, c.timestamp);
+			fwrite(c.rgb.data(), 1, c.rgb.size(), f);
+		}
+	}
+	fclose(f);
+	return true;
+}
+
+static bool readGolden(const char* path, GoldenHeader& h, std::vector<Run>& runs) {
+	FILE* f = fopen(path, "rb");
+	if (!f) return false;
+	char magic[4];
+	uint16_t version;
+	bool ok = fread(magic, 1, 4, f) == 4 && memcmp(magic, GOLDEN_MAGIC, 4) == 0
+		&& get16(f, version) && version == GOLDEN_VERSION
+		&& get16(f, h.numLeds) && get16(f, h.runs) && get16(f, h.frames)
+		&& get16(f, h.stepMs) && get16(f, h.every) && h.every > 0;
+	for (uint16_t r = 0; ok && r < h.runs; r++) {
+		Run run;
+		int program = fgetc(f), mode = fgetc(f);
+		ok = program >= 0 && mode >= 0;
+		run.program = program;
+		run.mode = mode;
+		for (int i = 0; ok && i < h.frames / h.every; i++) {
+			Capture c;
+			c.rgb.resize(h.numLeds * 3);
+			ok = get32(f, c.timestamp) && fread(c.rgb.data(), 1, c.rgb.size(), f) == c.rgb.size();
+			run.captures.push_back(c);
+		}
+		runs.push_back(run);
+	}
+	fclose(f);
+	return ok;
+}
+
+// Commands ************************************************************************
+
+static int record(const char* path, GoldenHeader h) {
+	std::vector<Run> runs = renderAll(h);
+	if (!writeGolden(path, h, runs)) {
+		fprintf(stderr, "cannot write %s\n", path);
+		return 1;
+	}
+	printf("recorded %zu runs x %d captures (%u LEDs) to %s\n",
+		   runs.size(), h.frames / h.every, h.numLeds, path);
+	return 0;
+}
+
+static int compare(const char* path, int tolerance, double minPsnr) {
+	GoldenHeader h;
+	std::vector<Run> golden;
+	if (!readGolden(path, h, golden)) {
+		fprintf(stderr, "cannot read %s (missing or not a golden file)\n", path);
+		return 1;
+	}
+	if (h.numLeds != simNumLeds) {
+		fprintf(stderr, "%s was recorded for %u LEDs, this build has %u\n", path, h.numLeds, simNumLeds);
+		return 1;
+	}
+
+	std::vector<Run> current = renderAll(h);
+	bool pass = current.size() == golden.size();
+
+	printf("name,program,mode,max_diff,over_tolerance,psnr_db\n");
+	for (size_t r = 0; r < current.size() && r < golden.size(); r++) {
+		const Run& a = golden[r];
+		const Run& b = current[r];
+		int maxDiff = 0;
+		uint32_t over = 0;
+		double sqErr = 0;
+		size_t samples = 0;
+		for (size_t c = 0; c < a.captures.size() && c < b.captures.size(); c++) {
+			for (size_t i = 0; i < a.captures[c].rgb.size(); i++) {
+				int d = abs((int)a.captures[c].rgb[i] - (int)b.captures[c].rgb[i]);
+				maxDiff = d > maxDiff ? d : maxDiff;
+				if (d > tolerance) over++;
+				sqErr += d * d;
+				samples++;
+			}
+		}
+		double mse = samples ? sqErr / samples : 0;
+		double psnr = mse > 0 ? 10.0 * log10(255.0 * 255.0 / mse) : INFINITY;
+		bool runPass = over == 0 && psnr >= minPsnr && a.program == b.program && a.mode == b.mode;
+		pass = pass && runPass;
+		printf("%s,%u,%u,%d,%u,%.2f%s\n", simVisualizerName(b.program, b.mode).c_str(),
+			   b.program, b.mode, maxDiff, over, psnr, runPass ? "" : ",FAIL");
+	}
+	printf(pass ? "PASS\n" : "FAIL\n");
+	return pass ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s record|compare FILE [--frames N] [--step MS] [--every N] [--tolerance N] [--min-psnr DB]\n", argv[0]);
+		return 2;
+	}
+	String command = argv[1];
+	const char* path = argv[2];
+
+	GoldenHeader h{simNumLeds, 0, 240, 16, 60};
+	int tolerance = 0;
+	double minPsnr = 0;
+	for (int i = 3; i + 1 < argc; i += 2) {
+		String arg = argv[i];
+		if (arg == "--frames") h.frames = atoi(argv[i + 1]);
+		else if (arg == "--step") h.stepMs = atoi(argv[i + 1]);
+		else if (arg == "--every") h.every = atoi(argv[i + 1]);
+		else if (arg == "--tolerance") tolerance = atoi(argv[i + 1]);
+		else if (arg == "--min-psnr") minPsnr = atof(argv[i + 1]);
+	}
+	if (h.every == 0 || h.frames < h.every) h.every = h.frames ? h.frames : 1;
+
+	setup();
+	sim::bleConnect();
+
+	if (command == "record") return record(path, h);
+	if (command == "compare") return compare(path, tolerance, minPsnr);
+	fprintf(stderr, "unknown command %s\n", command.c_str());
+	return 2;
+}
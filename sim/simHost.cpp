@@ -0,0 +1,157 @@
+// Host implementations for the Arduino/ESP32 stand-ins in sim/include and the
+// sim:: API used by the native runners.
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <driver/rtc_io.h>
+#include <chrono>
+#include <vector>
+
+#include "simHost.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+fs::LittleFSFS LittleFS;
+
+// Defined by bleControl.h in the firmware translation unit
+extern BLEServer* pServer;
+extern BLECharacteristic* pButtonCharacteristic;
+extern BLECharacteristic* pCheckboxCharacteristic;
+extern BLECharacteristic* pNumberCharacteristic;
+extern BLECharacteristic* pStringCharacteristic;
+
+namespace {
+	uint64_t simMicros = 0;
+	uint32_t randState = 1;
+	bool outputThread = false;
+}
+
+// Arduino core ********************************************************************
+
+uint32_t millis() { return (uint32_t)(simMicros / 1000); }
+uint32_t micros() { return (uint32_t)simMicros; }
+void delay(uint32_t ms) { simMicros += (uint64_t)ms * 1000; }
+
+uint32_t EspClass::getCycleCount() {
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	return (uint32_t)(ns * 240 / 1000);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+int digitalRead(uint8_t pin) { (void)pin; return LOW; }   // power button never pressed
+
+void randomSeed(unsigned long seed) { randState = seed ? seed : 1; }
+
+long random(long howbig) {
+	if (howbig <= 0) return 0;
+	// xorshift32: deterministic across hosts, unlike rand()
+	randState ^= randState << 13;
+	randState ^= randState >> 17;
+	randState ^= randState << 5;
+	return randState % howbig;
+}
+
+long random(long howsmall, long howbig) {
+	if (howsmall >= howbig) return howsmall;
+	return howsmall + random(howbig - howsmall);
+}
+
+void esp_deep_sleep_start() {
+	Serial.println("[sim] deep sleep requested, exiting");
+	exit(0);
+}
+
+namespace sim {
+
+	// Clock *************************************************************************
+
+	void setMillis(uint32_t ms) { simMicros = (uint64_t)ms * 1000; }
+	void advanceMillis(uint32_t ms) { simMicros += (uint64_t)ms * 1000; }
+	uint32_t nowMillis() { return millis(); }
+
+	// Output ************************************************************************
+
+	void OutputController::showPixels(PixelController<RGB>& pixels) {
+		auto start = std::chrono::steady_clock::now();
+		uint16_t n = 0;
+		while (pixels.has(1) && n < MAX_PIXELS) {
+			frame[n * 3 + 0] = pixels.loadAndScale0();
+			frame[n * 3 + 1] = pixels.loadAndScale1();
+			frame[n * 3 + 2] = pixels.loadAndScale2();
+			pixels.advanceData();
+			pixels.stepDithering();
+			n++;
+		}
+		frameSize = n;
+		shows++;
+		nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+	}
+
+	OutputController& output() {
+		static OutputController controller;
+		return controller;
+	}
+
+	void setThreadedOutput(bool threaded) { outputThread = threaded; }
+	bool threadedOutput() { return outputThread; }
+
+	// BLE ***************************************************************************
+
+	void bleConnect() {
+		if (pServer && pServer->getCallbacks()) pServer->getCallbacks()->onConnect(pServer);
+	}
+
+	void bleDisconnect() {
+		if (pServer && pServer->getCallbacks()) pServer->getCallbacks()->onDisconnect(pServer);
+	}
+
+	void bleButton(uint8_t value) {
+		if (pButtonCharacteristic) pButtonCharacteristic->simWrite(&value, 1);
+	}
+
+	void bleNumber(const char* id, float value) {
+		char buf[96];
+		snprintf(buf, sizeof(buf), "{\"id\":\"%s\",\"val\":%g}", id, value);
+		if (pNumberCharacteristic) pNumberCharacteristic->simWrite(String(buf));
+	}
+
+	void bleNumbers(const uint8_t* ids, const float* values, size_t count) {
+		std::vector<uint8_t> frame(1, 0xB1);
+		for (size_t i = 0; i < count; i++) {
+			const uint8_t* value = (const uint8_t*)&values[i];
+			frame.push_back(ids[i]);
+			frame.insert(frame.end(), value, value + sizeof(float));
+		}
+		if (pNumberCharacteristic) pNumberCharacteristic->simWrite(frame.data(), frame.size());
+	}
+
+	void bleCheckbox(const char* id, bool value) {
+		char buf[96];
+		snprintf(buf, sizeof(buf), "{\"id\":\"%s\",\"val\":%s}", id, value ? "true" : "false");
+		if (pCheckboxCharacteristic) pCheckboxCharacteristic->simWrite(String(buf));
+	}
+
+	String bleLastString() {
+		return pStringCharacteristic ? pStringCharacteristic->lastNotified : String();
+	}
+
+	// Helpers ***********************************************************************
+
+	NoiseError& noiseError() {
+		static NoiseError stats;
+		return stats;
+	}
+
+	uint32_t frameHash(const uint8_t* data, size_t size) {
+		uint32_t h = 2166136261u;
+		for (size_t i = 0; i < size; i++) {
+			h ^= data[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+} // namespace sim
@@ -0,0 +1,109 @@
+// Headless runner: boots the firmware against the host stand-ins and renders
+// every program (and every mode of programs that have them) for a fixed number
+// of frames on the simulated clock, printing a hash of the final output frame.
+//
+//   .pio/build/native/program [--frames N] [--step MS] [--program P] [--mode M] [--threaded] [--ble-thread]
+//
+// --threaded runs FastLED.show() on the render pipeline's output thread, as on
+// the device. The newest frame is always shown, but show counts (and, with
+// dithering, hashes) can differ where the output skipped to a newer frame.
+//
+// --ble-thread plays the Bluedroid task: during each run a second thread keeps
+// writing sliders and checkboxes through the characteristic callbacks while
+// loop() renders, so the command queue is exercised across threads (build
+// native_tsan to have ThreadSanitizer watch it). Hashes then depend on timing.
+
+#include <Arduino.h>
+#include <atomic>
+#include <thread>
+#include "simHost.h"
+
+void setup();
+void loop();
+
+extern const uint16_t simNumLeds;
+extern const uint8_t simProgramCount;
+extern const uint8_t* const simModeCounts;
+String simVisualizerName(uint8_t program, uint8_t mode);
+void simFlushOutput();
+uint32_t simDroppedCommands();
+
+// Slider drags and checkbox clicks as fast as a phone would send them; the only
+// BLE writer while it runs.
+void bleWriter(std::atomic<bool>& stop, uint32_t& writes) {
+	for (uint32_t n = 0; !stop.load(); n++) {
+		sim::bleNumber("inSpeed", 0.5f + (n % 16) * 0.1f);
+		sim::bleNumber("inZoom", 0.8f + (n % 8) * 0.05f);
+		sim::bleCheckbox("cxLayer2", n % 2);
+		writes += 3;
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+}
+
+int main(int argc, char** argv) {
+	int frames = 300;
+	int step = 16;
+	int onlyProgram = -1;
+	int onlyMode = -1;
+	bool bleThread = false;
+
+	for (int i = 1; i < argc; i++) {
+		String arg = argv[i];
+		const char* next = i + 1 < argc ? argv[i + 1] : "0";
+		if (arg == "--frames") { frames = atoi(next); i++; }
+		else if (arg == "--step") { step = atoi(next); i++; }
+		else if (arg == "--program") { onlyProgram = atoi(next); i++; }
+		else if (arg == "--mode") { onlyMode = atoi(next); i++; }
+		else if (arg == "--threaded") { sim::setThreadedOutput(true); }
+		else if (arg == "--ble-thread") { bleThread = true; }
+		else {
+			fprintf(stderr, "usage: %s [--frames N] [--step MS] [--program P] [--mode M] [--threaded] [--ble-thread]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	setup();
+	sim::bleConnect();
+	sim::bleNumber("inBright", 255);
+
+	printf("# %u LEDs, %d frames per run, %d ms per frame\n", simNumLeds, frames, step);
+	printf("name,program,mode,shows,hash\n");
+
+	for (uint8_t program = 0; program < simProgramCount; program++) {
+		if (onlyProgram >= 0 && program != onlyProgram) continue;
+		uint8_t modes = simModeCounts[program] ? simModeCounts[program] : 1;
+
+		for (uint8_t mode = 0; mode < modes; mode++) {
+			if (onlyMode >= 0 && mode != onlyMode) continue;
+
+			sim::bleButton(program);
+			if (simModeCounts[program]) sim::bleButton(20 + mode);
+			simFlushOutput();
+			sim::output().resetCounters();
+
+			std::atomic<bool> stopWriter(false);
+			uint32_t writes = 0;
+			std::thread writer;
+			if (bleThread) writer = std::thread(bleWriter, std::ref(stopWriter), std::ref(writes));
+
+			for (int f = 0; f < frames; f++) {
+				sim::advanceMillis(step);
+				loop();
+			}
+
+			if (bleThread) {
+				stopWriter = true;
+				writer.join();
+				loop();   // applies what the writer queued last
+				printf("# ble thread: %u writes, %u dropped so far\n", writes, simDroppedCommands());
+			}
+			simFlushOutput();
+
+			const sim::OutputController& out = sim::output();
+			printf("%s,%u,%u,%u,%08x\n", simVisualizerName(program, mode).c_str(),
+				   program, mode, out.showCount(),
+				   sim::frameHash(out.framebuffer(), out.size() * 3));
+		}
+	}
+	return 0;
+}
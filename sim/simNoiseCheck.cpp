@@ -0,0 +1,80 @@
+// Q16 noise accuracy check. Sweeps pnoise_q16() against pnoise_float() over the
+// coordinate ranges the Animartrix effects sample and fails if the error ever
+// exceeds sim::NOISE_Q16_MAX_ERROR. Unlike native_bench --noise-accuracy it does
+// not depend on which coordinates a run happens to visit.
+//
+//   pio run -e native_noise && .pio/build/native_noise/program [--samples N]
+//
+// Ranges:
+//   effects   x, y, z in [-256, 256]: one noise period each side of the
+//             origin, covering the +-200 the effects reach (native_bench
+//             --noise-accuracy reports coord_min / coord_max per mode)
+//   lattice   coordinates within a few Q16 steps of a cell edge, where the
+//             fade curves and the floor / wrap logic meet
+//   wrapped   |coordinate| up to 100000, through to_q16()'s fmod path
+
+#include <Arduino.h>
+#include <math.h>
+#include "simHost.h"
+
+double simNoiseError(float x, float y, float z);
+
+struct Range {
+	const char* name;
+	float (*pick)(uint32_t& seed);
+};
+
+static float unit(uint32_t& seed) {   // [0, 1), LCG so runs are reproducible
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) * (1.0f / 16777216);
+}
+
+static float effects(uint32_t& seed) { return unit(seed) * 512 - 256; }
+
+static float lattice(uint32_t& seed) {
+	const float cell = floorf(unit(seed) * 512 - 256);
+	const float steps = floorf(unit(seed) * 9) - 4;
+	return cell + steps * (1.0f / 65536);
+}
+
+static float wrapped(uint32_t& seed) { return unit(seed) * 200000 - 100000; }
+
+static const Range ranges[] = {
+	{"effects", effects},
+	{"lattice", lattice},
+	{"wrapped", wrapped},
+};
+
+int main(int argc, char** argv) {
+	uint32_t samples = 4000000;
+	for (int i = 1; i < argc; i++) {
+		String arg = argv[i];
+		if (arg == "--samples" && i + 1 < argc) { samples = atoi(argv[++i]); }
+		else {
+			fprintf(stderr, "usage: %s [--samples N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool ok = true;
+	printf("range,samples,max_abs_error,mean_abs_error,worst_x,worst_y,worst_z\n");
+	for (const Range& range : ranges) {
+		uint32_t seed = 1;
+		double maxAbs = 0, sumAbs = 0;
+		float worst[3] = {0, 0, 0};
+		for (uint32_t n = 0; n < samples; n++) {
+			const float x = range.pick(seed), y = range.pick(seed), z = range.pick(seed);
+			const double err = simNoiseError(x, y, z);
+			sumAbs += err;
+			if (err > maxAbs) {
+				maxAbs = err;
+				worst[0] = x; worst[1] = y; worst[2] = z;
+			}
+		}
+		printf("%s,%u,%.7f,%.7f,%.5f,%.5f,%.5f\n", range.name, samples, maxAbs,
+			   samples ? sumAbs / samples : 0.0, worst[0], worst[1], worst[2]);
+		if (maxAbs > sim::NOISE_Q16_MAX_ERROR) ok = false;
+	}
+	if (!ok) fprintf(stderr, "FAIL: Q16 noise error above %.1e\n", sim::NOISE_Q16_MAX_ERROR);
+	return ok ? 0 : 1;
+}
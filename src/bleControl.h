@@ -10,11 +10,15 @@
 #include <BLEUtils.h>
 #include <BLE2902.h>
 #include <string>
+#include <mutex>
 
 #include <FS.h>
 #include "LittleFS.h"
 #define FORMAT_LITTLEFS_IF_FAILED true 
 
+#include "frameProfiler.h"
+#include "commandQueue.h"
+
 bool displayOn = true;
 bool debug = false;
 bool pauseAnimation = false;
@@ -23,6 +27,7 @@ uint8_t dummy = 1;
 
 extern uint8_t PROGRAM;
 extern uint8_t MODE;
+extern FrameProfiler frameProfiler;
 
 using namespace fl;
 
@@ -89,17 +94,17 @@ using namespace fl;
    const char* const WAVES_PRIDE_PARAMS[] PROGMEM = {"speed", "hueIncMax", "blendFract", "brightTheta"};
    const char* const BLUR_PARAMS[] PROGMEM = {};
    const char* const FADE_PARAMS[] PROGMEM = {};
-   const char* const ANIMARTRIX_POLARWAVES_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "twist", "radius", "edge", "z", "ratBase", "ratDiff"};
-   const char* const ANIMARTRIX_SPIRALUS_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff"};
-   const char* const ANIMARTRIX_CALEIDO1_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff"};
-   const char* const ANIMARTRIX_COOLWAVES_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff"};
-   const char* const ANIMARTRIX_CHASINGSPIRALS_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "twist", "radius", "edge", "ratBase", "ratDiff", "offBase", "offDiff"};
-   const char* const ANIMARTRIX_COMPLEXKALEIDO6_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "twist", "radius", "edge", "z", "ratBase", "ratDiff"};
-   const char* const ANIMARTRIX_WATER_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff"};
-   const char* const ANIMARTRIX_EXPERIMENT1_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff"};
-   const char* const ANIMARTRIX_EXPERIMENT2_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff"};
-   const char* const ANIMARTRIX_TEST_PARAMS[] PROGMEM = {"zoom", "scale", "angle", "speedInt"};
-   const char* const FIRE_PARAMS[] PROGMEM = {};
+   const char* const ANIMARTRIX_POLARWAVES_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "twist", "radius", "edge", "z", "ratBase", "ratDiff", "keyRate"};
+   const char* const ANIMARTRIX_SPIRALUS_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff", "keyRate"};
+   const char* const ANIMARTRIX_CALEIDO1_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff", "keyRate"};
+   const char* const ANIMARTRIX_COOLWAVES_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff", "keyRate"};
+   const char* const ANIMARTRIX_CHASINGSPIRALS_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "twist", "radius", "edge", "ratBase", "ratDiff", "offBase", "offDiff", "keyRate"};
+   const char* const ANIMARTRIX_COMPLEXKALEIDO6_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "twist", "radius", "edge", "z", "ratBase", "ratDiff", "keyRate"};
+   const char* const ANIMARTRIX_WATER_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "keyRate"};
+   const char* const ANIMARTRIX_EXPERIMENT1_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "keyRate"};
+   const char* const ANIMARTRIX_EXPERIMENT2_PARAMS[] PROGMEM = {"speed", "zoom", "scale", "angle", "z", "ratBase", "ratDiff", "offBase", "offDiff", "keyRate"};
+   const char* const ANIMARTRIX_TEST_PARAMS[] PROGMEM = {"zoom", "scale", "angle", "speedInt", "keyRate"};
+   const char* const FIRE_PARAMS[] PROGMEM = {"keyRate"};
    const char* const DOTS_PARAMS[] PROGMEM = {};
    //const char* const _TEMP__PARAMS[] PROGMEM = {};
 
@@ -111,28 +116,29 @@ using namespace fl;
       uint8_t count;
    };
 
+   #define PARAM_COUNT(params) (sizeof(params) / sizeof((params)[0]))
+
    // String-based lookup table - mirrors JavaScript VISUALIZER_PARAMS
-   // Can number values be replace by an array element count?
    const VisualizerParamEntry VISUALIZER_PARAM_LOOKUP[] PROGMEM = {
-      {"rainbow", RAINBOW_PARAMS, 0},
-      {"waves-palette", WAVES_PALETTE_PARAMS, 4},
-      {"waves-pride", WAVES_PRIDE_PARAMS, 4},
-      {"animartrix-polarwaves", ANIMARTRIX_POLARWAVES_PARAMS, 10},
-      {"animartrix-spiralus", ANIMARTRIX_SPIRALUS_PARAMS, 9},
-      {"animartrix-caleido1", ANIMARTRIX_CALEIDO1_PARAMS, 9},
-      {"animartrix-coolwaves", ANIMARTRIX_COOLWAVES_PARAMS, 9},
-      {"animartrix-chasingspirals", ANIMARTRIX_CHASINGSPIRALS_PARAMS, 11},
-      {"animartrix-complexkaleido6", ANIMARTRIX_COMPLEXKALEIDO6_PARAMS, 10},
-      {"animartrix-water", ANIMARTRIX_WATER_PARAMS, 7},
-      {"animartrix-experiment1", ANIMARTRIX_EXPERIMENT1_PARAMS, 7},
-      {"animartrix-experiment2", ANIMARTRIX_EXPERIMENT2_PARAMS, 9},
-      {"animartrix-test", ANIMARTRIX_TEST_PARAMS, 8},
-      {"blur", BLUR_PARAMS, 0},
-      {"fade", FADE_PARAMS, 0},
-      {"fire", FIRE_PARAMS, 0},
-      {"fire", DOTS_PARAMS, 0}
-
-      //, {"_temp_", _TEMP__PARAMS, 0}
+      {"rainbow", RAINBOW_PARAMS, PARAM_COUNT(RAINBOW_PARAMS)},
+      {"waves-palette", WAVES_PALETTE_PARAMS, PARAM_COUNT(WAVES_PALETTE_PARAMS)},
+      {"waves-pride", WAVES_PRIDE_PARAMS, PARAM_COUNT(WAVES_PRIDE_PARAMS)},
+      {"animartrix-polarwaves", ANIMARTRIX_POLARWAVES_PARAMS, PARAM_COUNT(ANIMARTRIX_POLARWAVES_PARAMS)},
+      {"animartrix-spiralus", ANIMARTRIX_SPIRALUS_PARAMS, PARAM_COUNT(ANIMARTRIX_SPIRALUS_PARAMS)},
+      {"animartrix-caleido1", ANIMARTRIX_CALEIDO1_PARAMS, PARAM_COUNT(ANIMARTRIX_CALEIDO1_PARAMS)},
+      {"animartrix-coolwaves", ANIMARTRIX_COOLWAVES_PARAMS, PARAM_COUNT(ANIMARTRIX_COOLWAVES_PARAMS)},
+      {"animartrix-chasingspirals", ANIMARTRIX_CHASINGSPIRALS_PARAMS, PARAM_COUNT(ANIMARTRIX_CHASINGSPIRALS_PARAMS)},
+      {"animartrix-complexkaleido6", ANIMARTRIX_COMPLEXKALEIDO6_PARAMS, PARAM_COUNT(ANIMARTRIX_COMPLEXKALEIDO6_PARAMS)},
+      {"animartrix-water", ANIMARTRIX_WATER_PARAMS, PARAM_COUNT(ANIMARTRIX_WATER_PARAMS)},
+      {"animartrix-experiment1", ANIMARTRIX_EXPERIMENT1_PARAMS, PARAM_COUNT(ANIMARTRIX_EXPERIMENT1_PARAMS)},
+      {"animartrix-experiment2", ANIMARTRIX_EXPERIMENT2_PARAMS, PARAM_COUNT(ANIMARTRIX_EXPERIMENT2_PARAMS)},
+      {"animartrix-test", ANIMARTRIX_TEST_PARAMS, PARAM_COUNT(ANIMARTRIX_TEST_PARAMS)},
+      {"blur", BLUR_PARAMS, PARAM_COUNT(BLUR_PARAMS)},
+      {"fade", FADE_PARAMS, PARAM_COUNT(FADE_PARAMS)},
+      {"fire", FIRE_PARAMS, PARAM_COUNT(FIRE_PARAMS)},
+      {"fire", DOTS_PARAMS, PARAM_COUNT(DOTS_PARAMS)}
+
+      //, {"_temp_", _TEMP__PARAMS, PARAM_COUNT(_TEMP__PARAMS)}
    };
 
   class VisualizerManager {
@@ -224,10 +230,19 @@ float cBrightTheta = 1;
 //Dots
 float cTail = 1.f;
 
+// Keyframe rate in Hz for Animartrix and fire; frames in between are blended
+// (keyframes.h). 0 renders every frame.
+uint8_t cKeyRate = 0;
+
 //Domain Warper
 //float cWarpIntensity = 0.0f;
 //float cWarpSpeed = 1.0f;
 
+// Bumped whenever a slider that shapes per-pixel geometry changes, so renderers
+// can keep fields derived from it until it moves again. Which sliders count is
+// the geometry column of PARAMETER_TABLE.
+uint16_t geometryGeneration = 0;
+
 EaseType getEaseType(uint8_t value) {
     switch (value) {
         case 0: return EASE_NONE;
@@ -255,8 +270,24 @@ bool Layer4 = true;
 bool Layer5 = true;
 //bool warpEnabled = false;
 
-ArduinoJson::JsonDocument sendDoc;
-ArduinoJson::JsonDocument receivedJSON;
+ArduinoJson::JsonDocument receivedJSON;   // BLE task only
+
+// What the callbacks hand to loop(); see commandQueue.h
+enum BleCommandType : uint8_t {
+   COMMAND_BUTTON,
+   COMMAND_CHECKBOX,
+   COMMAND_NUMBER
+};
+
+struct BleCommand {
+   BleCommandType type;
+   uint8_t id;       // button value, checkbox index or NumberId
+   float value;
+};
+
+#define BLE_COMMAND_SLOTS 32        // a frame's worth of writes with room to spare
+
+CommandQueue<BleCommand, BLE_COMMAND_SLOTS> bleCommands;
 
 //*******************************************************************************
 //BLE CONFIGURATION *************************************************************
@@ -293,10 +324,27 @@ void startingPalette() {
 }
 
 // UI update functions ***********************************************
+// Receipts go out from the BLE callbacks and reports from the reply task
+// (see sendBleReplies()), so each builds its own document and sends through
+// notifyValue(), which keeps a characteristic's setValue() and notify() from
+// interleaving with another task's.
+
+std::mutex notifyLock;
+
+void notifyValue(BLECharacteristic* characteristic, const String& value) {
+   std::lock_guard<std::mutex> lock(notifyLock);
+   characteristic->setValue(value);
+   characteristic->notify();
+}
+
+void notifyValue(BLECharacteristic* characteristic, const uint8_t* data, size_t length) {
+   std::lock_guard<std::mutex> lock(notifyLock);
+   characteristic->setValue(data, length);
+   characteristic->notify();
+}
 
 void sendReceiptButton(uint8_t receivedValue) {
-   pButtonCharacteristic->setValue(String(receivedValue).c_str());
-   pButtonCharacteristic->notify();
+   notifyValue(pButtonCharacteristic, String(receivedValue));
    if (debug) {
       Serial.print("Button value received: ");
       Serial.println(receivedValue);
@@ -305,16 +353,14 @@ void sendReceiptButton(uint8_t receivedValue) {
 
 void sendReceiptCheckbox(String receivedID, bool receivedValue) {
   
-   sendDoc.clear();
+   ArduinoJson::JsonDocument sendDoc;
    sendDoc["id"] = receivedID;
    sendDoc["val"] = receivedValue;
 
    String jsonString;
    serializeJson(sendDoc, jsonString);
 
-   pCheckboxCharacteristic->setValue(jsonString);
-   
-   pCheckboxCharacteristic->notify();
+   notifyValue(pCheckboxCharacteristic, jsonString);
    
    if (debug) {
       Serial.print("Sent receipt for ");
@@ -326,16 +372,14 @@ void sendReceiptCheckbox(String receivedID, bool receivedValue) {
 
 void sendReceiptNumber(String receivedID, float receivedValue) {
 
-   sendDoc.clear();
+   ArduinoJson::JsonDocument sendDoc;
    sendDoc["id"] = receivedID;
    sendDoc["val"] = receivedValue;
 
    String jsonString;
    serializeJson(sendDoc, jsonString);
 
-   pNumberCharacteristic->setValue(jsonString);
-   
-   pNumberCharacteristic->notify();
+   notifyValue(pNumberCharacteristic, jsonString);
    
    if (debug) {
       Serial.print("Sent receipt for ");
@@ -347,16 +391,14 @@ void sendReceiptNumber(String receivedID, float receivedValue) {
 
 void sendReceiptString(String receivedID, String receivedValue) {
 
-   sendDoc.clear();
+   ArduinoJson::JsonDocument sendDoc;
    sendDoc["id"] = receivedID;
    sendDoc["val"] = receivedValue;
 
    String jsonString;
    serializeJson(sendDoc, jsonString);
 
-   pStringCharacteristic->setValue(jsonString);
-
-   pStringCharacteristic->notify();
+   notifyValue(pStringCharacteristic, jsonString);
    
    if (debug) {
       Serial.print("Sent receipt for ");
@@ -368,68 +410,177 @@ void sendReceiptString(String receivedID, String receivedValue) {
 
 //***********************************************************************
 // PARAMETER/PRESET MANAGEMENT SYSTEM ("PPMS")
-// X-Macro table 
+// X-Macro table: X(type, parameter, default, geometry). geometry is 1 for the
+// sliders that shape per-pixel geometry (see geometryGeneration).
 #define PARAMETER_TABLE \
-   X(uint8_t, OverrideMapping, 0) \
-   X(uint8_t, ColOrd, 1.0f) \
-   X(float, Speed, 1.0f) \
-   X(float, Zoom, 1.0f) \
-   X(float, Scale, 1.0f) \
-   X(float, Angle, 1.0f) \
-   X(float, Twist, 1.0f) \
-   X(float, Radius, 1.0f) \
-   X(float, Edge, 1.0f) \
-   X(float, Z, 1.0f) \
-   X(float, RatBase, 1.0f) \
-   X(float, RatDiff, 1.0f) \
-   X(float, OffBase, 1.0f) \
-   X(float, OffDiff, 1.0f) \
-   X(float, Red, 1.0f) \
-   X(float, Green, 1.0f) \
-   X(float, Blue, 1.0f) \
-   X(uint8_t, SpeedInt, 1) \
-   X(float, HueIncMax, 2500.0f) \
-   X(uint8_t, BlendFract, 128) \
-   X(float, BrightTheta, 1.0f) \
-   X(float, Tail, 1.0f) \
-   X(uint8_t, EaseSat, 0) \
-   X(uint8_t, EaseLum, 0) \
-
-
-// Auto-generated helper functions using X-macros
-void captureCurrentParameters(ArduinoJson::JsonObject& params) {
-    #define X(type, parameter, def) params[#parameter] = c##parameter;
+   X(uint8_t, OverrideMapping, 0, 0) \
+   X(uint8_t, ColOrd, 1.0f, 0) \
+   X(float, Speed, 1.0f, 0) \
+   X(float, Zoom, 1.0f, 1) \
+   X(float, Scale, 1.0f, 0) \
+   X(float, Angle, 1.0f, 1) \
+   X(float, Twist, 1.0f, 1) \
+   X(float, Radius, 1.0f, 1) \
+   X(float, Edge, 1.0f, 1) \
+   X(float, Z, 1.0f, 0) \
+   X(float, RatBase, 1.0f, 0) \
+   X(float, RatDiff, 1.0f, 0) \
+   X(float, OffBase, 1.0f, 0) \
+   X(float, OffDiff, 1.0f, 0) \
+   X(float, Red, 1.0f, 0) \
+   X(float, Green, 1.0f, 0) \
+   X(float, Blue, 1.0f, 0) \
+   X(uint8_t, SpeedInt, 1, 0) \
+   X(float, HueIncMax, 2500.0f, 0) \
+   X(uint8_t, BlendFract, 128, 0) \
+   X(float, BrightTheta, 1.0f, 0) \
+   X(float, Tail, 1.0f, 0) \
+   X(uint8_t, EaseSat, 0, 0) \
+   X(uint8_t, EaseLum, 0, 0) \
+   X(uint8_t, KeyRate, 0, 0) \
+
+
+// Per-frame parameter snapshot ***********************************************
+// loop() fills one of these right after applyBleCommands() and passes it by
+// const reference to the programs. Effect kernels then read a local,
+// unchanging copy instead of the mutable globals, which the compiler has to
+// reload after every store since they might alias the pixel buffers.
+struct FrameParams {
+   #define X(type, parameter, def, geometry) type parameter;
+   PARAMETER_TABLE
+   #undef X
+   bool Layer1, Layer2, Layer3, Layer4, Layer5;
+   bool rotateWaves;
+};
+
+void captureFrameParams(FrameParams& params) {
+   #define X(type, parameter, def, geometry) params.parameter = c##parameter;
+   PARAMETER_TABLE
+   #undef X
+   params.Layer1 = Layer1;
+   params.Layer2 = Layer2;
+   params.Layer3 = Layer3;
+   params.Layer4 = Layer4;
+   params.Layer5 = Layer5;
+   params.rotateWaves = rotateWaves;
+}
+
+// Number IDs for binary frames: the controls outside the table first, then
+// PARAMETER_TABLE in order. Add new parameters at the end of the table so
+// pages built against an older list keep their IDs.
+enum NumberId : uint8_t {
+   NUMBER_Bright,
+   NUMBER_PalNum,
+   NUMBER_FrameBudget,
+   #define X(type, parameter, def, geometry) NUMBER_##parameter,
+   PARAMETER_TABLE
+   #undef X
+   NUMBER_COUNT
+};
+
+// Same order; the names the JSON messages use
+const char* const numberNames[NUMBER_COUNT] = {
+   "inBright",
+   "inPalNum",
+   "inFrameBudget",
+   #define X(type, parameter, def, geometry) "in" #parameter,
+   PARAMETER_TABLE
+   #undef X
+};
+
+// Replies ***********************************************************************
+// Requests that need the render task's state (device state, profiler report,
+// preset save, preset receipts) are answered in two halves. processButton(), on the render
+// task, copies that state into a BleReply; sendBleReplies() then builds the
+// JSON, writes the preset file and notifies on the reply task, next to the BLE
+// stack, so neither costs the render task a frame.
+
+enum BleReplyType : uint8_t {
+   REPLY_DEVICE_STATE,
+   REPLY_PROFILER,
+   REPLY_SAVE_PRESET,
+   REPLY_PRESET_LOADED
+};
+
+struct BleReply {
+   BleReplyType type;
+   uint8_t preset;            // REPLY_SAVE_PRESET
+   uint8_t program, mode;
+   uint8_t quality, frameBudget;
+   FrameParams params;
+   ProfileSummary profile;    // REPLY_PROFILER
+   uint32_t shownFrames, skippedFrames, droppedCommands, showUs;
+   uint64_t changed;          // REPLY_PRESET_LOADED: bit per NumberId
+};
+
+#define BLE_REPLY_SLOTS 4
+
+CommandQueue<BleReply, BLE_REPLY_SLOTS> bleReplies;
+
+#define REPLY_TASK_CORE 0       // with the BLE stack
+#define REPLY_TASK_PRIORITY 1
+#define REPLY_TASK_STACK 8192   // JSON documents and LittleFS
+
+#ifndef AURORA_SIM
+TaskHandle_t replyTask = nullptr;
+#endif
+
+// Preset file persistence functions with JSON structure
+void captureCurrentParameters(ArduinoJson::JsonObject& params, const FrameParams& state) {
+    #define X(type, parameter, def, geometry) params[#parameter] = state.parameter;
     PARAMETER_TABLE
     #undef X
 }
 
-void applyCurrentParameters(const ArduinoJson::JsonObjectConst& params) {
-    #define X(type, parameter, def) \
+// A loaded preset travels whole, in its own queue: applyPresetLoads() sets all
+// of it between two frames, so a busy command queue can't leave it half done.
+struct PresetLoad {
+   uint8_t program;
+   int16_t mode;              // -1 keeps the current one
+   uint64_t present;          // bit per NumberId the file sets
+   FrameParams params;
+};
+
+static_assert(NUMBER_COUNT <= 64, "PresetLoad.present needs a bit per NumberId");
+
+#define PRESET_LOAD_SLOTS 2
+
+CommandQueue<PresetLoad, PRESET_LOAD_SLOTS> presetLoads;
+
+void readPresetParameters(const ArduinoJson::JsonObjectConst& params, PresetLoad& load) {
+    #define X(type, parameter, def, geometry) \
         if (!params[#parameter].isNull()) { \
-            auto newValue = params[#parameter].as<type>(); \
-            if (c##parameter != newValue) { \
-                c##parameter = newValue; \
-                sendReceiptNumber("in" #parameter, c##parameter); \
-            } \
+            load.params.parameter = params[#parameter].as<type>(); \
+            load.present |= 1ull << NUMBER_##parameter; \
         }
     PARAMETER_TABLE
     #undef X
 }
 
+// Reply task: receipts for what the preset actually changed, so the page's
+// sliders follow
+void sendPresetReceipts(const BleReply& state) {
+    #define X(type, parameter, def, geometry) \
+        if (state.changed & (1ull << NUMBER_##parameter)) { \
+            sendReceiptNumber("in" #parameter, state.params.parameter); \
+        }
+    PARAMETER_TABLE
+    #undef X
+}
 
-// Preset file persistence functions with JSON structure
-bool savePreset(int presetNumber) {
+// Reply task
+bool savePreset(const BleReply& state) {
     String filename = "/preset_";
-    filename += presetNumber;
+    filename += state.preset;
     filename += ".json";
     
     ArduinoJson::JsonDocument preset;
-    preset["programNum"] = PROGRAM;
-    if (MODE_COUNTS[PROGRAM] > 0) { 
-      preset["modeNum"] = MODE;
+    preset["programNum"] = state.program;
+    if (MODE_COUNTS[state.program] > 0) { 
+      preset["modeNum"] = state.mode;
     }    
     ArduinoJson::JsonObject params = preset["parameters"].to<ArduinoJson::JsonObject>();
-    captureCurrentParameters(params);
+    captureCurrentParameters(params, state.params);
     
     File file = LittleFS.open(filename, "w");
     if (!file) {
@@ -446,6 +597,7 @@ bool savePreset(int presetNumber) {
     return true;
 }
 
+// BLE task, from the button callback
 bool loadPreset(int presetNumber) {
     String filename = "/preset_";
     filename += presetNumber;
@@ -468,31 +620,40 @@ bool loadPreset(int presetNumber) {
         return false;
     }
 
-    PROGRAM = (uint8_t)preset["programNum"];
-    if (preset["modeNum"]) {
-      MODE = (uint8_t)preset["modeNum"];
+    PresetLoad load = {};
+    load.program = (uint8_t)preset["programNum"];
+    load.mode = preset["modeNum"] ? (uint8_t)preset["modeNum"] : -1;
+    readPresetParameters(preset["parameters"], load);
+    if (!presetLoads.push(load)) {
+        Serial.print("Preset load dropped, previous one still pending: ");
+        Serial.println(filename);
+        return false;
     }
-    pauseAnimation = true;
-    applyCurrentParameters(preset["parameters"]);
-    pauseAnimation = false;
     
     Serial.print("Preset loaded: ");
     Serial.println(filename);
     return true;
 }
 
+
 //***********************************************************************
 
-void sendDeviceState() { 
+void sendDeviceState(const BleReply& state) { 
    if (debug) {
       Serial.println("Sending device state...");
    }
    
    ArduinoJson::JsonDocument stateDoc;
-   stateDoc["program"] = PROGRAM;
-   stateDoc["mode"] = MODE;
+   stateDoc["program"] = state.program;
+   stateDoc["mode"] = state.mode;
+   stateDoc["quality"] = state.quality;          // 0 = full, see QualityLevel
+   stateDoc["frameBudget"] = state.frameBudget;  // ms; 0 = governor off
+
+   // Binary number frames understood for ids below this (see NumberId). The
+   // names stay out: the state has to fit in one notify.
+   stateDoc["numberIds"] = NUMBER_COUNT;
    
-   String currentVisualizer = VisualizerManager::getVisualizerName(PROGRAM, MODE); 
+   String currentVisualizer = VisualizerManager::getVisualizerName(state.program, state.mode); 
    
    // Get parameter list for current visualizer
    const VisualizerParamEntry* visualizerParams = VisualizerManager::getVisualizerParams(currentVisualizer);
@@ -500,7 +661,6 @@ void sendDeviceState() {
    ArduinoJson::JsonObject params = stateDoc["parameters"].to<ArduinoJson::JsonObject>();
 
    if (debug) {
-       String currentVisualizer = VisualizerManager::getVisualizerName(PROGRAM, MODE);
        Serial.print("Current visualizer: ");
        Serial.println(currentVisualizer);
        Serial.print("Found params: ");
@@ -532,14 +692,14 @@ void sendDeviceState() {
        bool paramFound = false;
        // Use X-macro to match parameter names and add values
        // Handle case-insensitive comparison for parameter names
-       #define X(type, parameter, def) \
+       #define X(type, parameter, def, geometry) \
            if (strcasecmp(paramName, #parameter) == 0) { \
-               params[paramName] = c##parameter; \
+               params[paramName] = state.params.parameter; \
                if (debug) { \
                    Serial.print("Added parameter "); \
                    Serial.print(paramName); \
                    Serial.print(": "); \
-                   Serial.println(c##parameter); \
+                   Serial.println(state.params.parameter); \
                } \
                paramFound = true; \
            }
@@ -559,15 +719,90 @@ void sendDeviceState() {
 }
 
 
+//***********************************************************************
+
+void sendProfilerReport(const BleReply& state) {
+
+   const ProfileSummary& summary = state.profile;
+
+   ArduinoJson::JsonDocument statsDoc;
+   statsDoc["board"] = BOARD_NAME;
+   statsDoc["visualizer"] = VisualizerManager::getVisualizerName(state.program, state.mode);
+   statsDoc["frames"] = summary.frames;
+   statsDoc["fps"] = summary.fps;
+   statsDoc["frameUs"] = summary.frameUs;
+   statsDoc["worstUs"] = summary.worstUs;
+   statsDoc["overBudget"] = summary.overBudget;
+   statsDoc["shownFrames"] = state.shownFrames;          // by the output task
+   statsDoc["skippedFrames"] = state.skippedFrames;      // replaced before it could be shown
+   statsDoc["droppedCommands"] = state.droppedCommands;  // BLE writes lost to a full queue
+   statsDoc["showUs"] = state.showUs;                    // latest FastLED.show(), on the output task
+
+   ArduinoJson::JsonObject stages = statsDoc["stageUs"].to<ArduinoJson::JsonObject>();
+   stages["render"] = summary.stageUs[STAGE_RENDER];
+   stages["prefs"] = summary.stageUs[STAGE_PREFS];
+   stages["publish"] = summary.stageUs[STAGE_PUBLISH];
+   stages["ble"] = summary.stageUs[STAGE_BLE];
+
+   String statsJson;
+   serializeJson(statsDoc, statsJson);
+   sendReceiptString("profiler", statsJson);
+}
+
+// Reply task: everything queueReply() handed over
+void sendBleReplies() {
+   BleReply reply;
+   while (bleReplies.pop(reply)) {
+      switch (reply.type) {
+         case REPLY_DEVICE_STATE: sendDeviceState(reply); break;
+         case REPLY_PROFILER:     sendProfilerReport(reply); break;
+         case REPLY_SAVE_PRESET:  savePreset(reply); break;
+         case REPLY_PRESET_LOADED: sendPresetReceipts(reply); break;
+      }
+   }
+}
+
+#ifndef AURORA_SIM
+void replyTaskLoop(void*) {
+   for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      sendBleReplies();
+   }
+}
+#endif
+
+// Render task: snapshot what the reply needs and hand it over
+void queueReply(BleReplyType type, uint8_t preset = 0, uint64_t changed = 0) {
+   BleReply reply = {};
+   reply.type = type;
+   reply.preset = preset;
+   reply.changed = changed;
+   reply.program = PROGRAM;
+   reply.mode = MODE;
+   reply.quality = governor.level();
+   reply.frameBudget = governor.budget();
+   captureFrameParams(reply.params);
+   if (type == REPLY_PROFILER) reply.profile = frameProfiler.summarize();
+   reply.shownFrames = pipeline.shownFrames();
+   reply.skippedFrames = pipeline.skippedFrames();
+   reply.showUs = pipeline.lastShowUs();
+   reply.droppedCommands = bleCommands.dropped();
+   if (!bleReplies.push(reply)) return;
+   #ifdef AURORA_SIM
+   sendBleReplies();   // no BLE stack to sit next to; answered inline
+   #else
+   if (replyTask) xTaskNotifyGive(replyTask);
+   #endif
+}
+
 // Handle UI request functions ***********************************************
 
 std::string convertToStdString(const String& flStr) {
    return std::string(flStr.c_str());
 }
 
+// Runs from applyBleCommands(), on the render task
 void processButton(uint8_t receivedValue) {
-
-   sendReceiptButton(receivedValue);
       
    if (receivedValue < 20) { // Program selection
       PROGRAM = receivedValue;
@@ -587,86 +822,178 @@ void processButton(uint8_t receivedValue) {
    }
 
    //if (receivedValue == 91) { updateUI(); }
-   if (receivedValue == 92) { sendDeviceState(); }
+   if (receivedValue == 92) { queueReply(REPLY_DEVICE_STATE); }
+   if (receivedValue == 93) { queueReply(REPLY_PROFILER); }
    //if (receivedValue == 94) { fancyTrigger = true; }
    //if (receivedValue == 95) { resetAll(); }
+   if (receivedValue == 96) { pauseAnimation = !pauseAnimation; } // freezes the frame clock
    
    if (receivedValue == 98) { displayOn = true; }
    if (receivedValue == 99) { displayOn = false; }
 
    if (receivedValue >= 101 && receivedValue <= 150) { 
       uint8_t savedPreset = receivedValue - 100;  
-      savePreset(savedPreset); 
+      queueReply(REPLY_SAVE_PRESET, savedPreset); 
    }
 
-   if (receivedValue >= 151 && receivedValue <= 200) { 
-       uint8_t presetToLoad = receivedValue - 150;
-       if (loadPreset(presetToLoad)) {
-           loadPreset(presetToLoad);
-           Serial.print("Loaded preset: ");
-           Serial.println(presetToLoad);
-       }
-   }
+   // 151-200 (load preset) never get here: the button callback reads the
+   // file and queues it whole (see PresetLoad)
 }
 
 //*****************************************************************************
 
-void processNumber(String receivedID, float receivedValue ) {
+// One setter per NumberId, so a binary entry dispatches without any string work
+typedef void (*NumberSetter)(float value);
 
-   sendReceiptNumber(receivedID, receivedValue);
-  
-   if (receivedID == "inBright") {
-      cBright = receivedValue;
+const NumberSetter numberSetters[NUMBER_COUNT] = {
+   [](float value) {
+      cBright = value;
       BRIGHTNESS = cBright;
       FastLED.setBrightness(BRIGHTNESS);
-   };
-
-
-   if (receivedID == "inPalNum") {
-      uint8_t newPalNum = receivedValue;
+   },
+   [](float value) {
+      uint8_t newPalNum = value;
       gTargetPalette = gGradientPalettes[ newPalNum ];
       if(debug) {
          Serial.print("newPalNum: ");
          Serial.println(newPalNum);
       }
-   };
-  
-   // Auto-generated custom parameter handling using X-macros
-   #define X(type, parameter, def) \
-       if (receivedID == "in" #parameter) { c##parameter = receivedValue; return; }
+   },
+   [](float value) {
+      // clamp before converting: a float outside 0-255 (or NaN) has no
+      // defined uint8_t value
+      float ms = value > 0 ? std::min(value, 255.0f) : 0.0f;
+      governor.setBudget((uint8_t)(ms + 0.5f));
+   },
+   #define X(type, parameter, def, geometry) \
+       [](float value) { \
+          const type newValue = value; \
+          if (c##parameter != newValue) { \
+             c##parameter = newValue; \
+             if (geometry) geometryGeneration++; \
+          } \
+       },
    PARAMETER_TABLE
    #undef X
+};
+
+// JSON fallback for pages that predate binary frames
+void processNumber(String receivedID, float receivedValue ) {
+
+   sendReceiptNumber(receivedID, receivedValue);
 
+   for (uint8_t id = 0; id < NUMBER_COUNT; id++) {
+      if (strcmp(receivedID.c_str(), numberNames[id]) == 0) {
+         bleCommands.push({COMMAND_NUMBER, id, receivedValue});
+         return;
+      }
+   }
+
+}
+
+// Binary number frame: NUMBER_FRAME_TAG, then any number of entries of
+// NumberId (1 byte) + value (float32, little-endian). JSON writes start with
+// '{', so the tag tells the two apart. The frame is echoed back whole as the
+// receipt, one notify for all its entries.
+#define NUMBER_FRAME_TAG 0xB1
+#define NUMBER_ENTRY_SIZE 5
+
+void processNumberFrame(const uint8_t* data, size_t length) {
+   if ((length - 1) % NUMBER_ENTRY_SIZE != 0) return;
+
+   for (size_t i = 1; i < length; i += NUMBER_ENTRY_SIZE) {
+      uint8_t id = data[i];
+      if (id >= NUMBER_COUNT) continue;   // newer page, unknown control
+      float value;
+      memcpy(&value, data + i + 1, sizeof(value));
+      bleCommands.push({COMMAND_NUMBER, id, value});
+      if (debug) {
+         Serial.print(numberNames[id]);
+         Serial.print(": ");
+         Serial.println(value);
+      }
+   }
+
+   notifyValue(pNumberCharacteristic, data, length);
 }
 
+struct CheckboxEntry {
+   const char* id;
+   bool* target;
+};
+
+const CheckboxEntry checkboxes[] = {
+   {"cx10", &rotateWaves},
+   {"cxLayer1", &Layer1},
+   {"cxLayer2", &Layer2},
+   {"cxLayer3", &Layer3},
+   {"cxLayer4", &Layer4},
+   {"cxLayer5", &Layer5},
+   {"cx11", &mappingOverride},
+};
+
 void processCheckbox(String receivedID, bool receivedValue ) {
    
    sendReceiptCheckbox(receivedID, receivedValue);
    
-   if (receivedID == "cx10") {rotateWaves = receivedValue;};
-   if (receivedID == "cxLayer1") {Layer1 = receivedValue;};
-   if (receivedID == "cxLayer2") {Layer2 = receivedValue;};
-   if (receivedID == "cxLayer3") {Layer3 = receivedValue;};
-   if (receivedID == "cxLayer4") {Layer4 = receivedValue;};
-   if (receivedID == "cxLayer5") {Layer5 = receivedValue;};
-   if (receivedID == "cx11") {mappingOverride = receivedValue;};
+   for (uint8_t i = 0; i < sizeof(checkboxes) / sizeof(checkboxes[0]); i++) {
+      if (strcmp(receivedID.c_str(), checkboxes[i].id) == 0) {
+         bleCommands.push({COMMAND_CHECKBOX, i, receivedValue ? 1.0f : 0.0f});
+         return;
+      }
+   }
 }
 
 void processString(String receivedID, String receivedValue ) {
    sendReceiptString(receivedID, receivedValue);
 }
 
+// Render task: a preset goes in whole, then the reply task sends receipts for
+// the values it changed
+void applyPresetLoads() {
+   PresetLoad load;
+   while (presetLoads.pop(load)) {
+      uint64_t changed = 0;
+      PROGRAM = load.program;
+      if (load.mode >= 0) MODE = load.mode;
+      #define X(type, parameter, def, geometry) \
+         if ((load.present & (1ull << NUMBER_##parameter)) && c##parameter != load.params.parameter) { \
+            c##parameter = load.params.parameter; \
+            if (geometry) geometryGeneration++; \
+            changed |= 1ull << NUMBER_##parameter; \
+         }
+      PARAMETER_TABLE
+      #undef X
+      if (changed) queueReply(REPLY_PRESET_LOADED, 0, changed);
+   }
+}
+
+// loop() calls this once per frame, before rendering: everything the callbacks
+// queued since the last frame is applied here, on the render task. Writes that
+// arrive meanwhile wait for the next frame. Preset loads go first.
+void applyBleCommands() {
+   applyPresetLoads();
+   BleCommand command;
+   for (uint8_t n = 0; n < BLE_COMMAND_SLOTS && bleCommands.pop(command); n++) {
+      switch (command.type) {
+         case COMMAND_BUTTON:   processButton(command.id); break;
+         case COMMAND_CHECKBOX: *checkboxes[command.id].target = command.value != 0.0f; break;
+         case COMMAND_NUMBER:   numberSetters[command.id](command.value); break;
+      }
+   }
+}
+
 //*******************************************************************************
 // CALLBACKS ********************************************************************
 
 class MyServerCallbacks: public BLEServerCallbacks {
-  void onConnect(BLEServer* pServer) {
+  void onConnect(BLEServer* /*pServer*/) {
     deviceConnected = true;
     wasConnected = true;
     if (debug) {Serial.println("Device Connected");}
   };
 
-  void onDisconnect(BLEServer* pServer) {
+  void onDisconnect(BLEServer* /*pServer*/) {
     deviceConnected = false;
     wasConnected = true;
   }
@@ -680,12 +1007,12 @@ class ButtonCharacteristicCallbacks : public BLECharacteristicCallbacks {
          
          uint8_t receivedValue = value[0];
          
-         if (debug) {
-            Serial.print("Button value received: ");
-            Serial.println(receivedValue);
+         sendReceiptButton(receivedValue);
+         if (receivedValue >= 151 && receivedValue <= 200) {
+            loadPreset(receivedValue - 150);   // file and JSON stay on this task
+         } else {
+            bleCommands.push({COMMAND_BUTTON, receivedValue, 0.0f});
          }
-         
-         processButton(receivedValue);
         
       }
    }
@@ -723,6 +1050,11 @@ class NumberCharacteristicCallbacks : public BLECharacteristicCallbacks {
    void onWrite(BLECharacteristic *characteristic) {
       
       String receivedBuffer = characteristic->getValue();
+
+      if (receivedBuffer.length() > 0 && (uint8_t)receivedBuffer[0] == NUMBER_FRAME_TAG) {
+         processNumberFrame((const uint8_t*)receivedBuffer.c_str(), receivedBuffer.length());
+         return;
+      }
       
       if (receivedBuffer.length() > 0) {
       
@@ -830,6 +1162,11 @@ void bleSetup() {
 
    pService->start();
 
+   #ifndef AURORA_SIM
+   xTaskCreatePinnedToCore(replyTaskLoop, "bleReplies", REPLY_TASK_STACK, nullptr,
+                           REPLY_TASK_PRIORITY, &replyTask, REPLY_TASK_CORE);
+   #endif
+
    BLEAdvertising *pAdvertising = BLEDevice::getAdvertising();
    pAdvertising->addServiceUUID(SERVICE_UUID);
    pAdvertising->setScanResponse(false);
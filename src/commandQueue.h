@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+// Command queue ****************************************************************
+// Bounded single-producer / single-consumer ring between the BLE callbacks
+// (Bluedroid task) and loop(). The callbacks only parse a write and push the
+// command; loop() drains the queue once per frame before it renders, so every
+// change lands between two frames and the render never sees a half-applied
+// one. Neither side blocks: a full queue drops the new command and counts it.
+//
+//   producer:  queue.push(cmd)
+//   consumer:  while (budget-- && queue.pop(cmd)) apply(cmd);
+//
+// N must be a power of two.
+
+template <typename T, uint16_t N>
+class CommandQueue {
+
+	static_assert((N & (N - 1)) == 0, "CommandQueue size must be a power of two");
+
+  public:
+
+	// Producer side only.
+	bool push(const T& item) {
+		const uint32_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) == N) {
+			dropCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		slots[h & (N - 1)] = item;
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side only.
+	bool pop(T& item) {
+		const uint32_t t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire)) return false;
+		item = slots[t & (N - 1)];
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	static constexpr uint16_t capacity() { return N; }
+	uint32_t dropped() const { return dropCount.load(std::memory_order_relaxed); }
+
+  private:
+
+	T slots[N];
+	std::atomic<uint32_t> head{0};        // next slot to write; producer owns it
+	std::atomic<uint32_t> tail{0};        // next slot to read; consumer owns it
+	std::atomic<uint32_t> dropCount{0};
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Single per-frame time source *************************************************
+// loop() calls tick() once per frame with the raw millis() value and hands
+// `now` to every program, so all effects in a frame see the same timestamp.
+// `now` is animation time: it follows real time and stands still while
+// `paused` is set, which is what pauseAnimation drives.
+
+struct FrameClock {
+
+	uint32_t now = 0;      // animation time for this frame (ms)
+	uint32_t delta = 0;    // animation ms elapsed since the previous frame
+	bool paused = false;
+
+	void tick(uint32_t ms) {
+		if (!started) {
+			lastMs = ms;
+			now = ms;
+			started = true;
+		}
+		uint32_t elapsed = ms - lastMs;
+		lastMs = ms;
+		delta = paused ? 0 : elapsed;
+		now += delta;
+	}
+
+  private:
+	bool started = false;
+	uint32_t lastMs = 0;
+};
+
+// Beats on animation time ******************************************************
+// FastLED's beatsin8/beatsin88 read millis() themselves and keep moving through
+// a pause; these give the same curves at a given `now`.
+
+inline uint16_t beat88At(uint32_t now, accum88 bpm88) {
+	return (now * bpm88 * 280) >> 16;
+}
+
+inline uint16_t beatsin88At(uint32_t now, accum88 bpm88, uint16_t lowest = 0, uint16_t highest = 65535) {
+	uint16_t beatsin = sin16(beat88At(now, bpm88)) + 32768;
+	return lowest + scale16(beatsin, highest - lowest);
+}
+
+inline uint8_t beatsin8At(uint32_t now, accum88 bpm, uint8_t lowest = 0, uint8_t highest = 255) {
+	if (bpm < 256) bpm <<= 8;   // whole bpm, as beat16() takes it
+	uint8_t beatsin = sin8(beat88At(now, bpm) >> 8);
+	return lowest + scale8(beatsin, highest - lowest);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Frame profiler ***************************************************************
+// loop() stamps the end of each stage with the CPU cycle counter; the cycles
+// are kept per frame in a small ring buffer together with the program/mode
+// that rendered it. summarize() turns the frames of the current visualizer
+// into fps, per-stage averages and the worst frame, which bleControl reports
+// over BLE (button 93) so field units can be profiled without a serial port.
+
+enum ProfileStage : uint8_t {
+	STAGE_PREFS = 0,   // EVERY_N_SECONDS(30) preference block
+	STAGE_RENDER,      // program render
+	STAGE_PUBLISH,     // copy into the output pipeline (FastLED.show() runs on the output task)
+	STAGE_BLE,         // queued BLE commands, reconnect handling
+	STAGE_COUNT
+};
+
+#define PROFILER_FRAMES 64
+#define PROFILER_BUDGET_US 16667   // frames longer than this count as dropped (60 fps)
+
+struct ProfileSummary {
+	uint8_t frames = 0;
+	float fps = 0;
+	float frameUs = 0;                 // average frame period
+	float worstUs = 0;                 // longest frame period
+	uint16_t overBudget = 0;
+	float stageUs[STAGE_COUNT] = {0};  // average per stage
+};
+
+class FrameProfiler {
+
+  public:
+
+	void beginFrame() {
+		uint32_t now = ESP.getCycleCount();
+		if (count > 0) {
+			samples[last].period = now - frameStart;
+		}
+		frameStart = now;
+		stageStart = now;
+		current = FrameSample();
+	}
+
+	void endStage(ProfileStage stage) {
+		uint32_t now = ESP.getCycleCount();
+		current.cycles[stage] += now - stageStart;
+		stageStart = now;
+	}
+
+	void endFrame(uint8_t program, uint8_t mode) {
+		current.program = program;
+		current.mode = mode;
+		last = head;
+		samples[head] = current;
+		head = (head + 1) % PROFILER_FRAMES;
+		if (count < PROFILER_FRAMES) count++;
+	}
+
+	// Render + publish time of the newest frame: the render task's own share,
+	// which is what the quality governor budgets.
+	uint32_t lastWorkUs() const {
+		if (count == 0) return 0;
+		const FrameSample& f = samples[last];
+		return (f.cycles[STAGE_RENDER] + f.cycles[STAGE_PUBLISH]) / ESP.getCpuFreqMHz();
+	}
+
+	// Only frames rendered by the most recent program/mode are included.
+	ProfileSummary summarize() const {
+		ProfileSummary s;
+		if (count == 0) return s;
+
+		const float cyclesPerUs = ESP.getCpuFreqMHz();
+		const FrameSample& newest = samples[last];
+		uint64_t periodSum = 0;
+		uint64_t stageSum[STAGE_COUNT] = {0};
+		uint32_t worst = 0;
+
+		for (uint8_t i = 0; i < count; i++) {
+			const FrameSample& f = samples[i];
+			// the newest frame has no period until the next one begins
+			if (f.period == 0 || f.program != newest.program || f.mode != newest.mode) continue;
+			s.frames++;
+			periodSum += f.period;
+			if (f.period > worst) worst = f.period;
+			if (f.period / cyclesPerUs > PROFILER_BUDGET_US) s.overBudget++;
+			for (uint8_t st = 0; st < STAGE_COUNT; st++) stageSum[st] += f.cycles[st];
+		}
+		if (s.frames == 0) return s;
+
+		s.frameUs = periodSum / cyclesPerUs / s.frames;
+		s.fps = s.frameUs > 0 ? 1e6f / s.frameUs : 0;
+		s.worstUs = worst / cyclesPerUs;
+		for (uint8_t st = 0; st < STAGE_COUNT; st++) {
+			s.stageUs[st] = stageSum[st] / cyclesPerUs / s.frames;
+		}
+		return s;
+	}
+
+  private:
+
+	struct FrameSample {
+		uint32_t cycles[STAGE_COUNT] = {0};
+		uint32_t period = 0;   // cycles from this frame's start to the next one's
+		uint8_t program = 0;
+		uint8_t mode = 0;
+	};
+
+	FrameSample samples[PROFILER_FRAMES];
+	FrameSample current;
+	uint8_t head = 0;
+	uint8_t last = 0;
+	uint8_t count = 0;
+	uint32_t frameStart = 0;
+	uint32_t stageStart = 0;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+// Keyframe interpolation *******************************************************
+// For slow-moving effects: render a keyframe only every 1/rate seconds and
+// fill the frames in between by blending the last two keyframes. The blend
+// runs in 16 bits per channel along a smoothstep curve, so a 20 Hz keyframe
+// rate still fades without visible steps at the display rate. The output
+// trails the effect by one keyframe period (50 ms at 20 Hz).
+//
+//   keys.setRate(cKeyRate);
+//   if (keys.due(now)) { render into leds; keys.push(leds, now); }
+//   keys.blend(leds, now);
+//
+// With the rate at 0 every frame is a keyframe and blend() does nothing.
+
+template <uint16_t N>
+class KeyframeBlender {
+
+  public:
+
+	void setRate(uint8_t hz) {
+		if (hz == rateHz) return;
+		rateHz = hz;
+		primed = false;   // restart from the next keyframe instead of blending across the change
+	}
+
+	uint8_t rate() const { return rateHz; }
+
+	// Start over, e.g. when the effect behind the keyframes changes.
+	void reset() { primed = false; }
+
+	bool due(uint32_t now) const {
+		return rateHz == 0 || !primed || now - keyTime >= period();
+	}
+
+	void push(const CRGB* frame, uint32_t now) {
+		if (rateHz == 0) return;
+		memcpy(previous, primed ? latest : frame, sizeof(previous));
+		memcpy(latest, frame, sizeof(latest));
+		keyTime = now;
+		primed = true;
+	}
+
+	// Overwrites out with the frame for `now` between the last two keyframes.
+	void blend(CRGB* out, uint32_t now) const {
+		if (rateHz == 0 || !primed) return;
+
+		uint32_t elapsed = now - keyTime;
+		if (elapsed > period()) elapsed = period();
+		uint16_t f = ease16((uint16_t)(elapsed * 65535 / period()));
+
+		const uint8_t* from = (const uint8_t*)previous;
+		const uint8_t* to = (const uint8_t*)latest;
+		uint8_t* dest = (uint8_t*)out;
+		for (uint16_t i = 0; i < N * 3; i++) {
+			// 8 -> 16 bit (x * 257), lerp, round back to 8 bit
+			int32_t a = from[i] * 257;
+			int32_t b = to[i] * 257;
+			int32_t mixed = a + (int32_t)(((int64_t)(b - a) * f) >> 16);
+			dest[i] = (mixed - (mixed >> 8) + 128) >> 8;   // exact inverse of * 257
+		}
+	}
+
+  private:
+
+	CRGB previous[N];
+	CRGB latest[N];
+	uint32_t keyTime = 0;
+	uint8_t rateHz = 0;
+	bool primed = false;
+
+	uint32_t period() const { return 1000 / rateHz; }
+
+	// smoothstep 3t^2 - 2t^3 on a 0-65535 scale
+	static uint16_t ease16(uint16_t t) {
+		uint64_t t2 = ((uint64_t)t * t) >> 16;
+		return (uint16_t)((t2 * (3 * 65536 - 2 * (uint64_t)t)) >> 16);
+	}
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <math.h>
+
+// LED layout files *************************************************************
+// A panel's physical layout can come from a file on LittleFS instead of the
+// generated wirings in matrixMap.h, so one firmware image covers panels that
+// are wired or shaped differently. Programs still render on the WIDTH x HEIGHT
+// raster (their buffers are sized from it at compile time); the file says
+// where each LED of the chain sits on that raster, between cells if need be
+// for rings and other irregular shapes. load() precomputes everything the
+// frame uses, so rendering does no coordinate math:
+//
+//   ledSources()         LED -> raster cell y * WIDTH + x it shows (the nearest
+//                        one), the output stage's gather table
+//   polarTheta/Distance  angle and distance of each cell's LED from the raster
+//                        centre, in Animartrix render order (x-major, y up)
+//
+// File format (little-endian):
+//   char     magic[4]        "ALAY"
+//   uint8_t  version         1
+//   uint8_t  width, height   raster the positions refer to; scaled to WIDTH x HEIGHT
+//                            on load, so a file drawn for another panel size fits
+//   uint8_t  reserved
+//   uint16_t count           LEDs on the chain, at most NUM_LEDS
+//   int16_t  x, y            per LED in chain order: raster position, 8.8 fixed point
+
+#define LAYOUT_VERSION 1
+
+template <uint16_t W, uint16_t H, uint16_t N>
+class LedLayout {
+
+  public:
+
+	bool load(fs::FS& fs, const char* path) {
+		loaded = false;
+		count = 0;
+		File file = fs.open(path, "r");
+		if (!file) return false;
+
+		uint8_t header[10];
+		const bool headerValid = file.readBytes(header, sizeof(header)) == sizeof(header) &&
+								 memcmp(header, "ALAY", 4) == 0 && header[4] == LAYOUT_VERSION &&
+								 header[5] > 0 && header[6] > 0;
+		const uint16_t leds = headerValid ? header[8] | (header[9] << 8) : 0;
+		if (leds == 0 || leds > N) {
+			file.close();
+			return false;
+		}
+
+		bool valid = true;
+		for (uint16_t n = 0; valid && n < leds; n++) {
+			uint8_t record[4];
+			valid = file.readBytes(record, sizeof(record)) == sizeof(record);
+			posX[n] = toRaster((int16_t)(record[0] | (record[1] << 8)), header[5], W);
+			posY[n] = toRaster((int16_t)(record[2] | (record[3] << 8)), header[6], H);
+		}
+		file.close();
+		if (!valid) return false;
+		count = leds;
+
+		buildSources();
+		buildCells();
+		buildPolar();
+		loaded = true;
+		return true;
+	}
+
+	bool isLoaded() const { return loaded; }
+	uint16_t size() const { return count; }
+
+	// N entries; LEDs past size() repeat cell 0 and stay unused by the strip
+	const uint16_t* ledSources() const { return ledCell; }
+	float* polarTheta() { return theta; }
+	float* polarDistance() { return distance; }
+
+  private:
+
+	bool loaded = false;
+	uint16_t count = 0;
+	int16_t posX[N], posY[N];           // 8.8 raster cells
+	uint16_t ledCell[N];                // LED -> raster cell
+	uint16_t cellLed[W * H];            // raster cell -> nearest LED, for the polar tables
+	float theta[W * H], distance[W * H];
+
+	// 8.8 position on a fileCells-wide raster -> the same spot on ours, keeping
+	// cell centres on cell centres (identity when the sizes match)
+	static int16_t toRaster(int16_t pos, uint8_t fileCells, uint16_t cells) {
+		int32_t scaled = ((int32_t)pos + 128) * cells / fileCells - 128;
+		return (int16_t)(scaled < INT16_MIN ? INT16_MIN : scaled > INT16_MAX ? INT16_MAX : scaled);
+	}
+
+	static uint16_t nearestCell(int16_t pos, uint16_t cells) {
+		int cell = (pos + 128) >> 8;
+		return cell < 0 ? 0 : cell >= cells ? cells - 1 : cell;
+	}
+
+	float ledX(uint16_t n) const { return posX[n] / 256.0f; }
+	float ledY(uint16_t n) const { return posY[n] / 256.0f; }
+
+	// Round each position to the nearest cell inside the raster.
+	void buildSources() {
+		for (uint16_t n = 0; n < N; n++) {
+			if (n >= count) {
+				ledCell[n] = 0;
+				continue;
+			}
+			ledCell[n] = nearestCell(posY[n], H) * W + nearestCell(posX[n], W);
+		}
+	}
+
+	void buildCells() {
+		for (uint16_t y = 0; y < H; y++) {
+			for (uint16_t x = 0; x < W; x++) {
+				uint16_t best = 0;
+				float bestD2 = INFINITY;
+				for (uint16_t n = 0; n < count; n++) {
+					float dx = ledX(n) - x, dy = ledY(n) - y;
+					float d2 = dx * dx + dy * dy;
+					if (d2 < bestD2) {
+						bestD2 = d2;
+						best = n;
+					}
+				}
+				cellLed[y * W + x] = best;
+			}
+		}
+	}
+
+	// Same centre and formulas as ANIMartRIX::fill_polar_tables(), so a plain
+	// grid layout gives the tables Animartrix builds for itself.
+	void buildPolar() {
+		const float cx = (W / 2) - 0.5;
+		const float cy = (H / 2) - 0.5;
+		int i = 0;
+		for (uint16_t x = 0; x < W; x++) {
+			for (uint16_t y = 0; y < H; y++) {
+				// Animartrix's y runs bottom-up
+				const uint16_t led = cellLed[(H - 1 - y) * W + x];
+				float dx = ledX(led) - cx;
+				float dy = (H - 1 - ledY(led)) - cy;
+				distance[i] = hypotf(dx, dy);
+				theta[i] = atan2f(dy, dx);
+				i++;
+			}
+		}
+	}
+};
@@ -14,24 +14,56 @@
 #include <Preferences.h>  
 Preferences preferences;
 
+#include "frameClock.h"
+FrameClock frameClock;
+
+#include "frameProfiler.h"
+FrameProfiler frameProfiler;
+
+#include "keyframes.h"
+
+#include "qualityGovernor.h"
+QualityGovernor governor;
+
 #define DATA_PIN_1 D0 // D2 for Charm; D0 for Pebble 
+#define BOARD_NAME "Pebble" // "Charm" or "Pebble"; reported with profiler stats
+#define FRAME_BUDGET_MS 16 // quality governor target (render + hand-off); 0 = off
 
 #define BUTTON_PIN_BITMASK 0x10 // On/off GPIO 4
 #define wakeupPin 4
 //const uint16_t shutdownCheckInterval = 500; 
 
-#include "matrixMap_10x6_portrait.h"
 #define WIDTH 6
 #define HEIGHT 10 
 #define NUM_LEDS ( WIDTH * HEIGHT )
 
+// Programs draw into leds[] as a row-major raster; publish() gathers it into
+// chain order through ledSource(), so no program deals with the wiring.
+inline uint16_t rasterXY(uint8_t x, uint8_t y) { return y * WIDTH + x; }
+
+#include "matrixMap.h"
+constexpr MatrixMappings<WIDTH, HEIGHT> mappings;
+
+// optional physical layout; when loaded it replaces the generated mappings
+#include "ledLayout.h"
+#define LAYOUT_FILE "/layout.bin"
+LedLayout<WIDTH, HEIGHT, NUM_LEDS> layout;
+
 const uint16_t MIN_DIMENSION = MIN(WIDTH, HEIGHT);
 const uint16_t MAX_DIMENSION = MAX(WIDTH, HEIGHT);
 
 CRGB leds[NUM_LEDS];
 CRGB leds2[NUM_LEDS];
 CRGB leds3[NUM_LEDS];
-uint16_t ledNum = 0;
+
+// programs render into leds[]; the output task shows published copies of it
+#include "renderPipeline.h"
+RenderPipeline<NUM_LEDS> pipeline;
+
+// Animartrix splits each frame's columns across these
+#include "workerPool.h"
+#define RENDER_WORKERS 0 // 0 = one per core
+WorkerPool renderWorkers;
 
 using namespace fl;
 
@@ -57,6 +89,8 @@ uint8_t defaultMapping = 0;
 bool mappingOverride = false;
 
 #include "bleControl.h"
+// this frame's controls, see captureFrameParams()
+FrameParams frameParams;
 //#include "domainWarper.h"
 
 #include "rainbow.hpp"
@@ -69,6 +103,35 @@ bool mappingOverride = false;
 
 //#include"_temp_.hpp
 
+#ifdef AURORA_SIM
+// Host simulation build (env:native): LEDs go to an in-memory framebuffer
+#include "simHost.h"
+extern const uint16_t simNumLeds = NUM_LEDS;
+extern const uint8_t simProgramCount = PROGRAM_COUNT;
+extern const uint8_t* const simModeCounts = MODE_COUNTS;
+String simVisualizerName(uint8_t program, uint8_t mode) {
+	return VisualizerManager::getVisualizerName(program, mode);
+}
+void simFlushOutput() { pipeline.flush(); }
+uint32_t simDroppedCommands() { return bleCommands.dropped(); }
+const uint16_t* ledSource();
+// leds[] in chain order, i.e. what publish() hands to the output side
+void simChainLeds(uint8_t* rgb) {
+	const uint16_t* source = ledSource();
+	for (uint16_t i = 0; i < NUM_LEDS; i++) memcpy(rgb + i * 3, leds[source[i]].raw, 3);
+}
+// |pnoise_q16 - pnoise_float| at one coordinate, for sim/simNoiseCheck.cpp
+struct SimNoiseProbe : animartrix_detail::ANIMartRIX {
+	uint16_t xyMap(uint16_t, uint16_t) override { return 0; }
+	void setPixelColorInternal(int, int, animartrix_detail::rgb) override {}
+};
+double simNoiseError(float x, float y, float z) {
+	static SimNoiseProbe probe;
+	const int32_t fixed = probe.pnoise_q16(probe.to_q16(x), probe.to_q16(y), probe.to_q16(z));
+	return fabs(fixed * (1.0 / 65536) - probe.pnoise_float(x, y, z));
+}
+#endif
+
 // Misc global variables ********************************************************************
 
 uint8_t savedSpeed;
@@ -78,14 +141,6 @@ uint8_t savedMode;
 
 // MAPPINGS **********************************************************************************
 
-extern const uint16_t progTopDown[NUM_LEDS] PROGMEM;
-extern const uint16_t progBottomUp[NUM_LEDS] PROGMEM;
-extern const uint16_t serpTopDown[NUM_LEDS] PROGMEM;
-extern const uint16_t serpBottomUp[NUM_LEDS] PROGMEM;
-extern const uint16_t vProgTopDown[NUM_LEDS] PROGMEM;
-extern const uint16_t vSerpTopDown[NUM_LEDS] PROGMEM;
-
-
 enum Mapping {
 	TopDownProgressive = 0,
 	TopDownSerpentine,
@@ -95,20 +150,15 @@ enum Mapping {
 	VerticalTopDownSerpentine
 }; 
 
-// General (non-FL::XYMap) mapping 
-	uint16_t myXY(uint8_t x, uint8_t y) {
-			if (x >= WIDTH || y >= HEIGHT) return 0;
-			uint16_t i = ( y * WIDTH ) + x;
-			switch(cMapping){
-				case 0:	 ledNum = progTopDown[i]; break;
-				case 1:	 ledNum = progBottomUp[i]; break;
-				case 2:	 ledNum = serpTopDown[i]; break;
-				case 3:	 ledNum = serpBottomUp[i]; break;
-				case 4:	 ledNum = vProgTopDown[i]; break;
-				case 5:	 ledNum = vSerpTopDown[i]; break;
-			}
-			return ledNum;
-	}
+// Raster cell shown by each LED, for the current mapping or the loaded layout
+const uint16_t* ledSource() {
+	return layout.isLoaded() ? layout.ledSources() : mappings.gather(cMapping);
+}
+
+// Animartrix draws with y = 0 at the bottom of the raster
+uint16_t bottomUpXY(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	return (height - 1 - y) * width + x;
+}
 
 // Used only for FL::XYMap purposes
 	/*
@@ -131,7 +181,7 @@ enum Mapping {
 	//uint16_t myXYFunction(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
 
 	//XYMap myXYmap = XYMap::constructWithUserFunction(WIDTH, HEIGHT, myXYFunction);
-	XYMap myXYmap = XYMap::constructWithLookUpTable(WIDTH, HEIGHT, progBottomUp);
+	XYMap myXYmap = XYMap::constructWithUserFunction(WIDTH, HEIGHT, bottomUpXY);
 	XYMap xyRect = XYMap::constructRectangularGrid(WIDTH, HEIGHT);
 
 //******************************************************************************************************************************
@@ -142,6 +192,7 @@ enum Mapping {
 #define FIRST_ANIMATION CHASING_SPIRALS
 fl::Animartrix myAnimartrix(myXYmap, FIRST_ANIMATION);
 FxEngine animartrixEngine(NUM_LEDS);
+KeyframeBlender<NUM_LEDS> animartrixKeys;
 
 void setColorOrder(int value) {
 	switch(value) {
@@ -155,23 +206,36 @@ void setColorOrder(int value) {
 	myAnimartrix.setColorOrder(static_cast<EOrder>(value));
 }
 
-void runAnimartrix() { 
+void runAnimartrix(uint32_t now, const FrameParams& params) { 
 	FastLED.setBrightness(cBright);
 	animartrixEngine.setSpeed(1);
 	
 	static auto lastColorOrder = -1;
-	if (cColOrd != lastColorOrder) {
-		setColorOrder(cColOrd);
-		lastColorOrder = cColOrd;
+	if (params.ColOrd != lastColorOrder) {
+		setColorOrder(params.ColOrd);
+		lastColorOrder = params.ColOrd;
 	} 
 
 	static auto lastFxIndex = savedMode;
 	if (cFxIndex != lastFxIndex) {
 		lastFxIndex = cFxIndex;
 		myAnimartrix.fxSet(cFxIndex);
+		animartrixKeys.reset();
 	}
 
-	animartrixEngine.draw(millis(), leds);
+	animartrix_detail::render_quality quality;
+	quality.layer_limit = governor.maxLayers(max_layers);
+	quality.fast_noise = governor.fastNoise();
+	quality.column_stride = governor.columnStride();
+	myAnimartrix.setRenderQuality(quality);
+	myAnimartrix.setFrameParams(params);
+
+	animartrixKeys.setRate(governor.keyRate(params.KeyRate));
+	if (animartrixKeys.due(now)) {
+		animartrixEngine.draw(now, leds);
+		animartrixKeys.push(leds, now);
+	}
+	animartrixKeys.blend(leds, now);
 }
 
 bool animartrixFirstRun = true;
@@ -198,8 +262,13 @@ void setup() {
 		PROGRAM = savedProgram;
 		MODE = savedMode;
 
-		FastLED.addLeds<WS2812B, DATA_PIN_1, GRB>(leds, NUM_LEDS)
+		#ifdef AURORA_SIM
+		FastLED.addLeds(&sim::output(), pipeline.shown, NUM_LEDS)
+				.setCorrection(TypicalLEDStrip);
+		#else
+		FastLED.addLeds<WS2812B, DATA_PIN_1, GRB>(pipeline.shown, NUM_LEDS)
 				.setCorrection(TypicalLEDStrip);
+		#endif
 				//.setDither(BRIGHTNESS < 255);
 
 		FastLED.setBrightness(BRIGHTNESS);
@@ -207,6 +276,14 @@ void setup() {
 		FastLED.clear();
 		FastLED.show();
 
+		// FastLED.show() only runs on the output task from here on
+		pipeline.begin();
+
+		renderWorkers.begin(RENDER_WORKERS);
+		myAnimartrix.setWorkerPool(&renderWorkers);
+
+		governor.setBudget(FRAME_BUDGET_MS);
+
 		if (debug) {
 			Serial.begin(115200);
 			delay(500);
@@ -229,6 +306,12 @@ void setup() {
 		}
 		Serial.println("LittleFS mounted successfully.");   
 
+		if (layout.load(LittleFS, LAYOUT_FILE)) {
+			myAnimartrix.setPolarTables(layout.polarTheta(), layout.polarDistance());
+			Serial.print("LED layout loaded: ");
+			Serial.println(layout.size());
+		}
+
 }
 
 //*****************************************************************************************
@@ -292,31 +375,45 @@ void loop() {
 
 		//EVERY_N_MILLISECONDS(shutdownCheckInterval) { shutdownCheck(); }
 
+		frameProfiler.beginFrame();
+
+		// BLE writes since the last frame, applied before anything reads them
+		applyBleCommands();
+		captureFrameParams(frameParams);
+		const FrameParams& params = frameParams;
+		frameProfiler.endStage(STAGE_BLE);
+
+		// one timestamp for everything rendered this frame
+		frameClock.paused = pauseAnimation;
+		frameClock.tick(millis());
+		const uint32_t now = frameClock.now;
+
 		EVERY_N_SECONDS(30) {
 			if ( BRIGHTNESS != savedBrightness ) updateSettings_brightness(BRIGHTNESS);
 			if ( SPEED != savedSpeed ) updateSettings_speed(SPEED);
 			if ( PROGRAM != savedProgram ) updateSettings_program(PROGRAM);
 			if ( MODE != savedMode ) updateSettings_mode(MODE);
 		}
+		frameProfiler.endStage(STAGE_PREFS);
  
 		if (!displayOn){
-			FastLED.clear();
+			fill_solid(leds, NUM_LEDS, CRGB::Black);
 		}
 		
 		else {
 			
 			//FastLED.setBrightness(BRIGHTNESS);
 
-			mappingOverride ? cMapping = cOverrideMapping : cMapping = defaultMapping;
+			mappingOverride ? cMapping = params.OverrideMapping : cMapping = defaultMapping;
 
 			switch(PROGRAM){
 
 				case 0:  
 					defaultMapping = Mapping::TopDownProgressive;
 					if (!rainbow::rainbowInstance) {
-						rainbow::initRainbow(myXY);
+						rainbow::initRainbow();
 					}
-					rainbow::runRainbow();
+					rainbow::runRainbow(now);
 					break; 
 
 				case 1:
@@ -325,7 +422,7 @@ void loop() {
 					if (!waves::wavesInstance) {
 						waves::initWaves();
 					}
-					waves::runWaves(); 
+					waves::runWaves(now, params);
 					break;
 
 				case 2:   
@@ -333,14 +430,14 @@ void loop() {
 						animartrixEngine.addFx(myAnimartrix);
 						animartrixFirstRun = false;
 					}
-					runAnimartrix();
+					runAnimartrix(now, params);
 					break;
 
 				case 3:  
 					if (!blur::blurInstance) {
 						blur::initBlur(myXYmap, xyRect);
 					}
-					blur::runBlur();
+					blur::runBlur(now);
 					break; 
 				
 				case 4:    
@@ -349,23 +446,23 @@ void loop() {
 						//fade::initFade(myXYmap, xyRect);
 						fade::initFade();
 					}
-					fade::runFade();
+					fade::runFade(now);
 					break;
 				
 				case 5:    
 					defaultMapping = Mapping::TopDownProgressive;
 					if (!fire::fireInstance) {
-						fire::initFire(myXY);
+						fire::initFire();
 					}
-					fire::runFire();
+					fire::runFire(now, params);
 					break;
 
 				case 6:    
 					defaultMapping = Mapping::TopDownProgressive;
 					if (!dots::dotsInstance) {
-						dots::initDots(myXY);
+						dots::initDots();
 					}
-					dots::runDots();
+					dots::runDots(frameClock.delta, params);
 					break;
 
 				/*
@@ -386,16 +483,19 @@ void loop() {
 			DomainWarper::enableWarpFilter(true);
 			if (DomainWarper::globalWarpFilter) {
 				DomainWarper::globalWarpFilter->setSpeed(cWarpSpeed);
-				DomainWarper::globalWarpFilter->applyWarpFilter(leds, myXY, millis(), cWarpIntensity);
+				DomainWarper::globalWarpFilter->applyWarpFilter(leds, rasterXY, millis(), cWarpIntensity);
 			}
 		} else {
 			DomainWarper::enableWarpFilter(false);
 		}
 		*/
+
+		frameProfiler.endStage(STAGE_RENDER);
 				
 	  	if (displayOn) {
-   	   		FastLED.show();
+   	   		pipeline.publish(leds, ledSource());
   		}
+		frameProfiler.endStage(STAGE_PUBLISH);
 	
 		// upon BLE disconnect
 		if (!deviceConnected && wasConnected) {
@@ -405,5 +505,9 @@ void loop() {
 			if (debug) {Serial.println("Start advertising");}
 			wasConnected = false;
 		}
+		frameProfiler.endStage(STAGE_BLE);
+
+		frameProfiler.endFrame(PROGRAM, MODE);
+		governor.frame(frameProfiler.lastWorkUs());
 
 } // loop()
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+
+// LED mappings *****************************************************************
+// Programs draw a row-major raster (i = y * WIDTH + x, y = 0 at the top); the
+// wiring decides which LED on the chain shows which raster cell. The output
+// stage gathers with gather(cMapping): LED n shows raster cell table[n]. The
+// tables are generated at compile time for any WIDTH x HEIGHT, so a new panel
+// size needs no hand-typed tables. Indices follow cMapping.
+
+enum MappingTable : uint8_t {
+	MAP_PROG_TOP_DOWN = 0,
+	MAP_PROG_BOTTOM_UP,
+	MAP_SERP_TOP_DOWN,
+	MAP_SERP_BOTTOM_UP,
+	MAP_VPROG_TOP_DOWN,
+	MAP_VSERP_TOP_DOWN,
+	MAP_COUNT
+};
+
+// LED on the chain that shows raster cell i
+constexpr uint16_t mappedIndex(uint8_t mapping, uint16_t i, uint16_t w, uint16_t h) {
+	const uint16_t x = i % w, y = i / w;
+	// the vertical layouts run down columns, so they split i by the height instead
+	const uint16_t column = i / h, row = i % h;
+	switch (mapping) {
+		case MAP_PROG_BOTTOM_UP:  return y * w + (w - 1 - x);
+		case MAP_SERP_TOP_DOWN:   return (h - 1 - y) * w + (y % 2 == 0 ? w - 1 - x : x);
+		case MAP_SERP_BOTTOM_UP:  return y * w + (y % 2 == 0 ? w - 1 - x : x);
+		case MAP_VPROG_TOP_DOWN:  return (w - 1 - column) + w * (h - 1 - row);
+		case MAP_VSERP_TOP_DOWN:  return (w - 1 - column) + w * (column % 2 == 0 ? h - 1 - row : row);
+		default:                  return (h - 1 - y) * w + (w - 1 - x);
+	}
+}
+
+template <uint16_t W, uint16_t H>
+struct MatrixMappings {
+
+	uint16_t source[MAP_COUNT][W * H];   // source[m][led] = raster cell
+
+	constexpr MatrixMappings() : source() {
+		for (uint8_t m = 0; m < MAP_COUNT; m++) {
+			for (uint16_t i = 0; i < W * H; i++) source[m][mappedIndex(m, i, W, H)] = i;
+		}
+	}
+
+	// Unknown mappings fall back to MAP_PROG_TOP_DOWN.
+	constexpr const uint16_t* gather(uint8_t mapping) const {
+		return source[mapping < MAP_COUNT ? mapping : (uint8_t)MAP_PROG_TOP_DOWN];
+	}
+};
@@ -1,26 +0,0 @@
-#include <Arduino.h>
-#include <FastLED.h>
-
-const uint16_t progTopDown[60] PROGMEM = {
-59,58,57,56,55,54,53,52,51,50,49,48,47,46,45,44,43,42,41,40,39,38,37,36,35,34,33,32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0
-};
-
-const uint16_t progBottomUp[60] PROGMEM = {
-5,4,3,2,1,0,11,10,9,8,7,6,17,16,15,14,13,12,23,22,21,20,19,18,29,28,27,26,25,24,35,34,33,32,31,30,41,40,39,38,37,36,47,46,45,44,43,42,53,52,51,50,49,48,59,58,57,56,55,54
-};
-
-const uint16_t serpTopDown[60] PROGMEM = {
-59,58,57,56,55,54,48,49,50,51,52,53,47,46,45,44,43,42,36,37,38,39,40,41,35,34,33,32,31,30,24,25,26,27,28,29,23,22,21,20,19,18,12,13,14,15,16,17,11,10,9,8,7,6,0,1,2,3,4,5
-};
-
-const uint16_t serpBottomUp[60] PROGMEM = {
-5,4,3,2,1,0,6,7,8,9,10,11,17,16,15,14,13,12,18,19,20,21,22,23,29,28,27,26,25,24,30,31,32,33,34,35,41,40,39,38,37,36,42,43,44,45,46,47,53,52,51,50,49,48,54,55,56,57,58,59
-};
-
-const uint16_t vProgTopDown[60] PROGMEM = {
-59,53,47,41,35,29,23,17,11,5,58,52,46,40,34,28,22,16,10,4,57,51,45,39,33,27,21,15,9,3,56,50,44,38,32,26,20,14,8,2,55,49,43,37,31,25,19,13,7,1,54,48,42,36,30,24,18,12,6,0
-};
-
-const uint16_t vSerpTopDown[60] PROGMEM = {
-59,53,47,41,35,29,23,17,11,5,4,10,16,22,28,34,40,46,52,58,57,51,45,39,33,27,21,15,9,3,2,8,14,20,26,32,38,44,50,56,55,49,43,37,31,25,19,13,7,1,0,6,12,18,24,30,36,42,48,54
-};
\ No newline at end of file
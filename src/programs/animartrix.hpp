@@ -20,6 +20,8 @@ My personal learning playground for working with:
 #include "eorder.h"
 #include "pixel_controller.h"
 
+#include "workerPool.h"
+
 #define ANIMARTRIX_INTERNAL
 #include "animartrix_detail.hpp"
 
@@ -63,6 +65,18 @@ namespace fl {
             void fxNext(int fx = 1) { fxSet(fxGet() + fx); }
             void setColorOrder(EOrder order) { color_order = order; }
             EOrder getColorOrder() const { return color_order; }
+            // Splits each frame's columns across the pool; nullptr renders on the caller only.
+            void setWorkerPool(WorkerPool *pool) { workers = pool; }
+            // Applied from the next frame on; see QualityGovernor.
+            void setRenderQuality(const animartrix_detail::render_quality &q) { quality = q; }
+            // Controls for the next draw(); copied into the renderer when it starts.
+            void setFrameParams(const FrameParams &p) { frameParams = &p; }
+            // Polar tables of a loaded LedLayout, in render order, instead of the
+            // centred grid. nullptr goes back to the grid.
+            void setPolarTables(float *theta, float *dist) {
+                layoutTheta = theta;
+                layoutDistance = dist;
+            }
 
         private:
             friend void AnimartrixLoop(Animartrix &self, uint32_t now);
@@ -73,6 +87,11 @@ namespace fl {
             CRGB *leds = nullptr; // Only set during draw, then unset back to nullptr.
             AnimartrixAnim current_animation = CHASING_SPIRALS;
             EOrder color_order = RGB;
+            WorkerPool *workers = nullptr;
+            animartrix_detail::render_quality quality;
+            const FrameParams *frameParams = nullptr;
+            float *layoutTheta = nullptr;
+            float *layoutDistance = nullptr;
 
     };
 
@@ -88,15 +107,44 @@ namespace fl {
 
     class FastLEDANIMartRIX : public animartrix_detail::ANIMartRIX {
         Animartrix *data = nullptr;
+        // xyMap() of every pixel in render order (i = x * num_y + y)
+        fl::HeapVector<uint16_t> mapped;
+        const float *boundTheta = nullptr; // setPolarTables() the tables came from
 
         public:
             FastLEDANIMartRIX(Animartrix *_data) {
                 this->data = _data;
                 this->init(data->getWidth(), data->getHeight());
+                mapped.resize(num_x * num_y, 0);
+                for (int x = 0; x < num_x; x++) {
+                    for (int y = 0; y < num_y; y++) {
+                        mapped[x * num_y + y] = data->xyMap(x, y);
+                    }
+                }
+                bindPolarTables();
+            }
+
+            void bindPolarTables() {
+                if (data->layoutTheta) {
+                    use_polar_tables(data->layoutTheta, data->layoutDistance);
+                } else if (boundTheta) {
+                    bind_polar_tables();
+                }
+                boundTheta = data->layoutTheta;
+            }
+
+            // Byte k of a stored pixel takes channel order[k] (0 = red).
+            void colorOrderBytes(uint8_t order[3]) const {
+                order[0] = RGB_BYTE0(data->color_order);
+                order[1] = RGB_BYTE1(data->color_order);
+                order[2] = RGB_BYTE2(data->color_order);
             }
 
             void setPixelColor(int x, int y, CRGB pixel) {
-                data->leds[xyMap(x, y)] = pixel;
+                uint8_t order[3];
+                colorOrderBytes(order);
+                data->leds[mapped[x * num_y + y]] =
+                    CRGB(pixel.raw[order[0]], pixel.raw[order[1]], pixel.raw[order[2]]);
             }
             void setPixelColorInternal(int x, int y,
                                     animartrix_detail::rgb pixel) override {
@@ -106,6 +154,15 @@ namespace fl {
             uint16_t xyMap(uint16_t x, uint16_t y) override {
                 return data->xyMap(x, y);
             }
+            // xyMap() is a look-up table by now, so column ranges can write leds[] concurrently.
+            void parallel_for(int count, void (*job)(void *, int, int),
+                              void *ctx) override {
+                if (data->workers) {
+                    data->workers->run(count, job, ctx);
+                } else {
+                    job(ctx, 0, count);
+                }
+            }
 
             void loop();
     
@@ -133,8 +190,8 @@ namespace fl {
     void AnimartrixLoop(Animartrix &self, uint32_t now) {
         if (self.prev_animation != self.current_animation) {
             if (self.impl) {
-                // Re-initialize object.
-                self.impl->init(self.getWidth(), self.getHeight());
+                // New effect, same matrix: only the oscillators start over.
+                self.impl->reset_effect_state();
             }
             self.prev_animation = self.current_animation;
         }
@@ -169,6 +226,15 @@ namespace fl {
 
 
     void FastLEDANIMartRIX::loop() {
+        if (boundTheta != data->layoutTheta) bindPolarTables();
+
+        // render_layers() stores straight into leds[], already in color_order
+        uint8_t order[3];
+        colorOrderBytes(order);
+        set_direct_output(data->leds, mapped.data(), order);
+        quality = data->quality;
+        if (data->frameParams) params = *data->frameParams;
+
         for (const auto &entry : ANIMATION_TABLE) {
             if (entry.anim == data->current_animation) {
                 (this->*entry.func)();
@@ -193,18 +259,8 @@ namespace fl {
 
     void Animartrix::draw(DrawContext ctx) {
         this->leds = ctx.leds;
+        // pixels are stored in color_order as they're written, so no swizzle pass
         AnimartrixLoop(*this, ctx.now);
-        if (color_order != RGB) {   
-            for (int i = 0; i < mXyMap.getTotal(); ++i) {
-                CRGB &pixel = ctx.leds[i];
-                const uint8_t b0_index = RGB_BYTE0(color_order);
-                const uint8_t b1_index = RGB_BYTE1(color_order);
-                const uint8_t b2_index = RGB_BYTE2(color_order);
-                pixel = CRGB(pixel.raw[b0_index], pixel.raw[b1_index],
-                            pixel.raw[b2_index]);
-            }
-
-        }
         this->leds = nullptr;
     }
 
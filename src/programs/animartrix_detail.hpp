@@ -39,6 +39,24 @@ License CC BY-NC 3.0
 #include <math.h>
 #include "fl/stdint.h"
 
+// Noise arithmetic. ANIMARTRIX_NOISE_Q16=1 switches pnoise() to the Q16
+// fixed-point pipeline (pnoise_q16), trading a bounded error for integer-only
+// math; pnoise_float() stays available as the reference.
+#ifndef ANIMARTRIX_NOISE_Q16
+#define ANIMARTRIX_NOISE_Q16 0
+#endif
+
+// Batched noise backend. ANIMARTRIX_PNOISE_BATCH can name a platform kernel
+// with the pnoise_batch() signature (e.g. one for the ESP32-S3 vector unit);
+// x86 hosts get the SSE2 kernel below, everything else the scalar loop.
+#if !defined(ANIMARTRIX_PNOISE_BATCH) && defined(__SSE2__) &&                 \
+    !defined(ANIMARTRIX_NO_SIMD) && !ANIMARTRIX_NOISE_Q16
+#define ANIMARTRIX_PNOISE_SSE2 1
+#include <emmintrin.h>
+#else
+#define ANIMARTRIX_PNOISE_SSE2 0
+#endif
+
 #ifndef ANIMARTRIX_INTERNAL
 #error                                                                         \
     "This file is not meant to be included directly. Include animartrix.hpp instead."
@@ -71,6 +89,10 @@ License CC BY-NC 3.0
 
 #include "bleControl.h"
 
+#ifdef AURORA_SIM
+#include "simHost.h"
+#endif
+
 #ifndef FL_ANIMARTRIX_USES_FAST_MATH
 #define FL_ANIMARTRIX_USES_FAST_MATH 1
 #endif
@@ -107,18 +129,8 @@ FL_OPTIMIZATION_LEVEL_O3_BEGIN
 namespace animartrix_detail {
 FASTLED_USING_NAMESPACE
 
-struct render_parameters {
-    float center_x = (999 / 2) - 0.5; // center of the matrix
-    float center_y = (999 / 2) - 0.5;
-    float dist, angle;
-    float scale_x = .1; // smaller values = zoom in
-    float scale_y = .1;
-    float scale_z = .1;
-    float offset_x, offset_y, offset_z;
-    float z;
-    float low_limit = 0; // getting contrast by raising the black point
-    float high_limit = 1;
-};
+// Noise-space point every layer's x and y are offset from
+#define noise_center ((999 / 2) - 0.5f)
 
 struct oscillators {
     float master_speed; // global transition speed
@@ -126,6 +138,21 @@ struct oscillators {
     float ratio[num_oscillators]; // speed ratios for the individual oscillators
 };
 
+// Oscillator phases, one accumulator per oscillator and output, each held as
+// a 64-bit fraction of its period so neither precision nor speed decays with
+// uptime (drift after 30 days of 16 ms frames: well under one linear unit).
+// linear_period is a multiple of 256 (the noise period) divided by the usual
+// layer scales, so the wrap is seamless at default slider settings.
+#define linear_period 25600.0f
+#define radial_period 6.28318531f
+#define noise_period 256.0f
+
+struct phases {
+    uint64_t linear[num_oscillators];
+    uint64_t radial[num_oscillators];
+    uint64_t noise[num_oscillators];
+};
+
 struct modulators {
     float linear[num_oscillators];      // returns 0 to FLT_MAX
     float radial[num_oscillators];      // returns 0 to 2*PI
@@ -144,6 +171,114 @@ struct rgb {
     float red, green, blue;
 };
 
+// Per-pixel cos/sin of the static part of a layer angle,
+// angle = k_theta * polar_theta + k_dist * distance.
+// Rebuilt only when the coefficients (the Angle/Twist/Zoom sliders) change.
+struct rotation_cache {
+    fl::HeapVector<float> cos_a, sin_a;
+    float k_theta = 0, k_dist = 0;
+    bool valid = false;
+};
+
+// The per-frame part of a layer angle, usually an oscillator.
+struct frame_rotation {
+    float angle, cos_a, sin_a;
+};
+
+// Centred polar tables for one matrix size, built on first use and shared by
+// every ANIMartRIX of that size (see bind_polar_tables()).
+struct polar_geometry {
+    int num_x = 0, num_y = 0;
+    fl::HeapVector<float> storage;
+    float *polar_theta = nullptr;
+    float *distance = nullptr;
+};
+
+#define max_polar_geometries 4
+
+// Per-pixel terms that only depend on the polar tables and the geometry
+// sliders; rebuilt when geometryGeneration (bleControl.h) moves.
+struct static_fields {
+    fl::HeapVector<float> dimmer; // radialFilterFactor(radius * params.Radius, distance, params.Edge)
+    uint16_t generation = 0;
+    bool valid = false;
+};
+
+// Layer engine *****************************************************************
+// An effect is up to max_layers noise layers plus a channel_mix. Per pixel
+// (d = distance, theta = polar_theta) a layer samples the noise field at
+//
+//   dist  = dist_0 + dist_d * d + dist_d2 * d^2
+//           + wave_amp * sin(wave_freq * d + wave_phase)
+//   angle = angle_theta * theta + angle_d * d + angle_0
+//   x     = (offset_x + noise_center - cos(angle) * dist) * scale_x
+//   y     = (offset_y + noise_center - sin(angle) * dist) * scale_y
+//   z     = (offset_z + z_0 + z_d * d) * scale_z
+//
+// and maps it to 0-255 between low_limit and high_limit. Effects set the
+// coefficients from sliders and oscillators once per frame; render_layers()
+// evaluates them layer-major over the pixel arrays. The static part of the
+// angle comes from a rotation_cache, except for layers whose angle_d follows
+// an oscillator (twist_per_frame): a cache keyed on it would be rebuilt every
+// frame, so those compute the angle per pixel instead.
+
+#define max_layers 5
+#define num_rotation_caches max_layers
+
+struct layer {
+    bool enabled = false;
+    float dist_0 = 0, dist_d = 0, dist_d2 = 0;
+    float wave_amp = 0, wave_freq = 0, wave_phase = 0;
+    float angle_theta = 0, angle_d = 0, angle_0 = 0;
+    bool twist_per_frame = false; // angle_d changes every frame: no rotation cache
+    float z_0 = 0, z_d = 0;
+    float offset_x = 0, offset_y = 0, offset_z = 0;
+    float scale_x = .1, scale_y = .1, scale_z = .1;
+    float low_limit = 0, high_limit = 1;
+};
+
+// How layers combine into a pixel, per channel c (red, green, blue):
+//   out[c] = (bias[c] + sum_n weight[c][n] * layer[n]) * modifier[c] * gain[c]
+// gain is params.Red/params.Green/params.Blue when color_gains is set, 1 otherwise.
+enum channel_modifier : uint8_t {
+    MIX_PLAIN,
+    MIX_RADIAL_DIMMER, // * radialFilterFactor(radius * params.Radius, distance, params.Edge)
+    MIX_DISTANCE,      // * distance
+};
+
+struct channel_mix {
+    float weight[3][max_layers];
+    float bias[3];
+    uint8_t modifier[3];
+    bool color_gains;
+    bool hsv; // instead: hue = time / 100 + sum of all layers, full sat/val
+};
+
+// Trade-offs a frame-time governor may ask for; the defaults render every
+// effect as designed.
+struct render_quality {
+    // Layers n >= layer_limit are skipped even when enabled: render_layers()
+    // already drops disabled ones at every setting, so a cap is the only
+    // layer saving left to offer. It changes the picture; it's the mildest step.
+    int layer_limit = max_layers;
+    bool fast_noise = false;      // pnoise_q16() instead of the float noise
+    int column_stride = 1;        // 2: evaluate every other column, repeat it
+};
+
+// Layer-major scratch: entry n * pixels + i for layer n, pixel i.
+struct layer_buffers {
+    fl::HeapVector<float> x, y, z, value;
+};
+
+// A layer's caches and per-frame rotations, looked up once per frame so the
+// column workers only read shared state.
+struct layer_plan {
+    const rotation_cache *rot = nullptr;
+    const rotation_cache *wave = nullptr; // null without a distance wave
+    frame_rotation turn = {0, 1, 0};
+    frame_rotation wave_turn = {0, 1, 0};
+};
+
 static const uint8_t PERLIN_NOISE[] = {
     151, 160, 137, 91,  90,  15,  131, 13,  201, 95,  96,  53,  194, 233, 7,
     225, 140, 36,  103, 30,  69,  142, 8,   99,  37,  240, 21,  10,  23,  190,
@@ -173,32 +308,54 @@ FASTLED_FORCE_INLINE uint8_t P(uint8_t x) {
 class ANIMartRIX {
 
   public:
-    int num_x; // how many LEDs are in one row?
-    int num_y; // how many rows?
+    int num_x = 0; // how many LEDs are in one row?
+    int num_y = 0; // how many rows?
 
     float speed_factor = 1; // 0.1 to 10
 
     float radial_filter_radius = 23.0; // on 32x32, use 11 for 16x16
-    float radialDimmer = 1;
-    float radialFilterFalloff = 1;
-
-    bool serpentine;
 
-    render_parameters animation; // all animation parameters in one place
     oscillators timings;         // all speed settings in one place
     modulators move; // all oscillator based movers and shifters at one place
-    rgb pixel;
+    phases phase;    // accumulated oscillator phases behind move
+    uint32_t phase_time = 0;
+    bool phase_started = false;
     filters filter;
 
-    fl::HeapVector<fl::HeapVector<float>>
-        polar_theta; // look-up table for polar angles
-    fl::HeapVector<fl::HeapVector<float>>
-        distance; // look-up table for polar distances
+    // Polar look-up tables, one float per pixel in render order
+    // (x-major, i = x * num_y + y) so every column is a contiguous run.
+    // Both live in one 16-byte aligned block to keep them out of the way of
+    // heap fragmentation and usable by vector loads.
+    float *polar_theta = nullptr; // look-up table for polar angles
+    float *distance = nullptr;    // look-up table for polar distances
+    fl::HeapVector<float> polar_storage;
+    int polar_size = 0;
+    bool polar_shared = false; // tables point into a shared polar_geometry
+
+    // Trig-free rotation: layers whose angle is "static per pixel + per frame"
+    // combine cached cos/sin with the angle-addition identity.
+    rotation_cache rotation[num_rotation_caches];
+    rotation_cache waves[max_layers]; // sin/cos(wave_freq * distance) per layer
+
+    static_fields fields;
+
+    layer layers[max_layers];
+    int layer_count = 0;
+    layer_buffers buffers;
+    layer_plan plans[max_layers];        // resolved caches, per render_layers()
+    const channel_mix *frame_mix = nullptr;
+    render_quality quality;
+    // This frame's controls. The effects and the column workers read these,
+    // never the globals in bleControl.h, so a frame renders with one set.
+    FrameParams params = {};
+
+    // Direct output, see set_direct_output()
+    CRGB *direct_leds = nullptr;
+    const uint16_t *direct_index = nullptr;
+    uint8_t direct_order[3] = {0, 1, 2};
 
     //unsigned long a, b, c; // for time measurements
 
-    float show1, show2, show3, show4, show5, show6, show7, show8, show9, show0;
-
     ANIMartRIX() {}
 
     ANIMartRIX(int w, int h) { this->init(w, h); }
@@ -209,23 +366,45 @@ class ANIMartRIX {
 
     uint32_t currentTime = 0;
     void setTime(uint32_t t) { currentTime = t; }
-    uint32_t getTime() { return currentTime ? currentTime : millis(); }
+    uint32_t getTime() { return currentTime; }
+
+    // Lets render_layers() store pixel i (render order, i = x * num_y + y)
+    // as leds[index[i]], byte k taken from channel order[k] (0 = red), with
+    // no virtual calls. Pass nullptr leds to go back to setPixelColorInternal().
+    void set_direct_output(CRGB *leds, const uint16_t *index,
+                           const uint8_t order[3]) {
+        direct_leds = leds;
+        direct_index = index;
+        for (int k = 0; k < 3; k++) direct_order[k] = order[k];
+    }
 
     void init(int w, int h) {
-        animation = render_parameters();
-        timings = oscillators();
-        move = modulators();
-        pixel = rgb();
+        reset_effect_state();
+
+        // same size: shared polar tables, layer caches and buffers all still hold
+        if (w == num_x && h == num_y && polar_shared) return;
 
         this->num_x = w;
         this->num_y = h;
 
         this->radial_filter_radius = std::min(w,h) * 0.65;
        
-        // precalculate all polar coordinates; polar origin is set to matrix centre
-        render_polar_lookup_table(
-            (num_x / 2) - 0.5,
-            (num_y / 2) - 0.5);  
+        // polar origin is set to matrix centre
+        bind_polar_tables();
+
+        const int entries = max_layers * num_x * num_y;
+        buffers.x.resize(entries, 0.0f);
+        buffers.y.resize(entries, 0.0f);
+        buffers.z.resize(entries, 0.0f);
+        buffers.value.resize(entries, 0.0f);
+    }
+
+    // Per-effect state only: what a mode switch has to start from scratch.
+    void reset_effect_state() {
+        timings = oscillators();
+        move = modulators();
+        phase = phases();
+        phase_started = false;
         
         // Set default speed ratio for the oscillators. Not all effects set their own.
         timings.master_speed = 0.01;
@@ -290,6 +469,14 @@ class ANIMartRIX {
     }
 
     float pnoise(float x, float y, float z) {
+#if ANIMARTRIX_NOISE_Q16
+        return pnoise_q16(to_q16(x), to_q16(y), to_q16(z)) * (1.0f / 65536);
+#else
+        return pnoise_float(x, y, z);
+#endif
+    }
+
+    float pnoise_float(float x, float y, float z) {
 
         int X = (int)floorf(x) & 255, /* FIND UNIT CUBE THAT */
             Y = (int)floorf(y) & 255, /* CONTAINS POINT.     */
@@ -318,33 +505,246 @@ class ANIMartRIX {
                               grad(P(BB + 1), x - 1, y - 1, z - 1))));
     }
 
+    // Q16 fixed point *********************************************
+    // Same lattice, hashes and gradients as pnoise_float(); coordinates,
+    // fades and blends are 16.16 integers. The noise period is 256, so the
+    // integer part only needs 8 bits and coordinates are wrapped before
+    // conversion. Against pnoise_float() the error stays below 2^-12 for
+    // coordinates within +-200 (0.05 of a 0-255 level after scale_noise());
+    // env:native_noise asserts the bound on a sweep, env:native_bench
+    // --noise-accuracy on the live effects.
+
+    static int32_t to_q16(float v) {
+        if (v >= 32767.0f || v <= -32767.0f) v = fmodf(v, 256.0f);
+        return (int32_t)(v * 65536.0f);
+    }
+
+    // 6t^5 - 15t^4 + 10t^3 for t in [0, 1] (Q16)
+    static int32_t fade_q16(int32_t t) {
+        int32_t r = t * 6 - (15 << 16);
+        r = (int32_t)(((int64_t)t * r) >> 16) + (10 << 16);
+        r = (int32_t)(((int64_t)t * r) >> 16);
+        r = (int32_t)(((int64_t)t * r) >> 16);
+        return (int32_t)(((int64_t)t * r) >> 16);
+    }
+
+    static int32_t lerp_q16(int32_t t, int32_t a, int32_t b) {
+        return a + (int32_t)(((int64_t)t * (b - a)) >> 16);
+    }
+
+    static int32_t grad_q16(int hash, int32_t x, int32_t y, int32_t z) {
+        int h = hash & 15;
+        int32_t u = h < 8 ? x : y,
+                v = h < 4                ? y
+                    : h == 12 || h == 14 ? x
+                                         : z;
+        return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+    }
+
+    // Q16 in, Q16 out (roughly -1..1)
+    int32_t pnoise_q16(int32_t x, int32_t y, int32_t z) {
+        const int32_t one = 1 << 16;
+        int X = (x >> 16) & 255, // arithmetic shift == floor
+            Y = (y >> 16) & 255,
+            Z = (z >> 16) & 255;
+        x &= 0xFFFF;
+        y &= 0xFFFF;
+        z &= 0xFFFF;
+        int32_t u = fade_q16(x), v = fade_q16(y), w = fade_q16(z);
+        int A = P(X) + Y, AA = P(A) + Z, AB = P(A + 1) + Z,
+            B = P(X + 1) + Y, BA = P(B) + Z, BB = P(B + 1) + Z;
+
+        return lerp_q16(w,
+                        lerp_q16(v,
+                                 lerp_q16(u, grad_q16(P(AA), x, y, z),
+                                          grad_q16(P(BA), x - one, y, z)),
+                                 lerp_q16(u, grad_q16(P(AB), x, y - one, z),
+                                          grad_q16(P(BB), x - one, y - one, z))),
+                        lerp_q16(v,
+                                 lerp_q16(u, grad_q16(P(AA + 1), x, y, z - one),
+                                          grad_q16(P(BA + 1), x - one, y, z - one)),
+                                 lerp_q16(u, grad_q16(P(AB + 1), x, y - one, z - one),
+                                          grad_q16(P(BB + 1), x - one, y - one, z - one))));
+    }
+
+    // out[k] = pnoise(x[k], y[k], z[k]) for k < n
+    void pnoise_batch(const float *x, const float *y, const float *z,
+                      float *out, int n) {
+        if (quality.fast_noise) {
+            for (int k = 0; k < n; k++) {
+                out[k] = pnoise_q16(to_q16(x[k]), to_q16(y[k]), to_q16(z[k])) *
+                         (1.0f / 65536);
+            }
+            return;
+        }
+#if defined(ANIMARTRIX_PNOISE_BATCH)
+        ANIMARTRIX_PNOISE_BATCH(x, y, z, out, n);
+#else
+        int k = 0;
+#if ANIMARTRIX_PNOISE_SSE2
+        for (; k + 4 <= n; k += 4) {
+            pnoise4_sse2(x + k, y + k, z + k, out + k);
+        }
+#endif
+        for (; k < n; k++) {
+            out[k] = pnoise(x[k], y[k], z[k]);
+        }
+#endif
+    }
+
+#if ANIMARTRIX_PNOISE_SSE2
+    // Four lanes of pnoise(). Only the permutation look-ups stay scalar.
+
+    static __m128 floor4(__m128 v) {
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.0f)));
+    }
+
+    static __m128 fade4(__m128 t) {
+        __m128 p = _mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(-15.0f));
+        p = _mm_add_ps(_mm_mul_ps(t, p), _mm_set1_ps(10.0f));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), p);
+    }
+
+    static __m128 lerp4(__m128 t, __m128 a, __m128 b) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    static __m128 select4(__m128i mask, __m128 a, __m128 b) {
+        __m128 m = _mm_castsi128_ps(mask);
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+
+    // branch-free grad(): lane masks pick u/v, the low two hash bits flip signs
+    static __m128 grad4(__m128i hash, __m128 x, __m128 y, __m128 z) {
+        __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+        __m128 u = select4(_mm_cmplt_epi32(h, _mm_set1_epi32(8)), x, y);
+        __m128i h12or14 = _mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                       _mm_cmpeq_epi32(h, _mm_set1_epi32(14)));
+        __m128 v = select4(_mm_cmplt_epi32(h, _mm_set1_epi32(4)), y,
+                           select4(h12or14, x, z));
+        __m128 sign_u = _mm_castsi128_ps(
+            _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+        __m128 sign_v = _mm_castsi128_ps(
+            _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+        return _mm_add_ps(_mm_xor_ps(u, sign_u), _mm_xor_ps(v, sign_v));
+    }
+
+    void pnoise4_sse2(const float *px, const float *py, const float *pz,
+                      float *out) {
+        __m128 x = _mm_loadu_ps(px), y = _mm_loadu_ps(py), z = _mm_loadu_ps(pz);
+        __m128 fx = floor4(x), fy = floor4(y), fz = floor4(z);
+
+        alignas(16) int32_t X[4], Y[4], Z[4];
+        _mm_store_si128((__m128i *)X, _mm_cvttps_epi32(fx));
+        _mm_store_si128((__m128i *)Y, _mm_cvttps_epi32(fy));
+        _mm_store_si128((__m128i *)Z, _mm_cvttps_epi32(fz));
+
+        x = _mm_sub_ps(x, fx);
+        y = _mm_sub_ps(y, fy);
+        z = _mm_sub_ps(z, fz);
+        __m128 u = fade4(x), v = fade4(y), w = fade4(z);
+
+        // corner hashes, in the order pnoise() blends them
+        alignas(16) int32_t h[8][4];
+        for (int l = 0; l < 4; l++) {
+            int A = P(X[l] & 255) + (Y[l] & 255), AA = P(A) + (Z[l] & 255),
+                AB = P(A + 1) + (Z[l] & 255),
+                B = P((X[l] & 255) + 1) + (Y[l] & 255), BA = P(B) + (Z[l] & 255),
+                BB = P(B + 1) + (Z[l] & 255);
+            h[0][l] = P(AA);
+            h[1][l] = P(BA);
+            h[2][l] = P(AB);
+            h[3][l] = P(BB);
+            h[4][l] = P(AA + 1);
+            h[5][l] = P(BA + 1);
+            h[6][l] = P(AB + 1);
+            h[7][l] = P(BB + 1);
+        }
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        __m128 x1 = _mm_sub_ps(x, one), y1 = _mm_sub_ps(y, one),
+               z1 = _mm_sub_ps(z, one);
+        __m128i H[8];
+        for (int c = 0; c < 8; c++) {
+            H[c] = _mm_load_si128((const __m128i *)h[c]);
+        }
+
+        __m128 r = lerp4(w,
+                         lerp4(v,
+                               lerp4(u, grad4(H[0], x, y, z),
+                                     grad4(H[1], x1, y, z)),
+                               lerp4(u, grad4(H[2], x, y1, z),
+                                     grad4(H[3], x1, y1, z))),
+                         lerp4(v,
+                               lerp4(u, grad4(H[4], x, y, z1),
+                                     grad4(H[5], x1, y, z1)),
+                               lerp4(u, grad4(H[6], x, y1, z1),
+                                     grad4(H[7], x1, y1, z1))));
+        _mm_storeu_ps(out, r);
+    }
+#endif
+
     //***************************************************************
 
-    void calculate_oscillators(oscillators &timings) {
+    // noise_angles: bit n set if the effect reads move.noise_angle[n]; the
+    // others are left at 0 to save a pnoise() each.
+    void calculate_oscillators(oscillators &timings, uint16_t noise_angles = 0) {
+
+        // advance by the frame delta; the first frame after init() advances from
+        // t = 0, so phases match the old absolute-time formula (mod the periods)
+        const uint32_t now = getTime();
+        const uint32_t delta = phase_started ? now - phase_time : now;
+        phase_time = now;
+        phase_started = true;
 
         // global animation speed
-        double runtime = getTime() * timings.master_speed * speed_factor; 
+        const float runtime_step = delta * timings.master_speed * speed_factor;
 
         for (int i = 0; i < num_oscillators; i++) {
 
-            // continously rising offsets, returns 0 to max_float
+            const float step = runtime_step * timings.ratio[i];
+            const float offset = timings.offset[i] * timings.ratio[i];
+            advance_phase(phase.linear[i], step, linear_period);
+            advance_phase(phase.radial[i], step, radial_period);
+            advance_phase(phase.noise[i], step, noise_period);
+
+            // continously rising offsets, returns 0 to linear_period
             move.linear[i] = 
-                (runtime + timings.offset[i]) * timings.ratio[i];
+                read_phase(phase.linear[i], offset, linear_period);
 
             // angle offsets for continous rotation, returns 0 to 2 * PI
             move.radial[i] = 
-                fmodf(move.linear[i], 2 * PI); 
+                read_phase(phase.radial[i], offset, radial_period);
 
             // directional offsets or factors, returns -1 to 1
             move.directional[i] = 
                 FL_SIN_F(move.radial[i]); 
 
             // noise based angle offset, returns 0 to 2 * PI
-            move.noise_angle[i] =
-                PI * (1 + pnoise(move.linear[i], 0, 0));
+            move.noise_angle[i] = (noise_angles & (1 << i))
+                ? (float)PI * (1 + pnoise(read_phase(phase.noise[i], offset, noise_period), 0, 0))
+                : 0;
            
         }
     }
+
+    // acc += amount, with acc counting 1/2^64 of period
+    static void advance_phase(uint64_t &acc, float amount, float period) {
+        float turns = amount / period;
+        turns -= floorf(turns);
+        acc += (uint64_t)(turns * 18446742974197923840.0f); // largest float below 2^64
+    }
+
+    // acc + offset, wrapped into [0, period)
+    static float read_phase(uint64_t acc, float offset, float period) {
+        float value = (uint32_t)(acc >> 32) * (period / 4294967296.0f) + offset;
+        if (value >= period || value < 0) {
+            value = fmodf(value, period);
+            if (value < 0) value += period;
+        }
+        return value;
+    }
  
     //***************************************************************
     void run_default_oscillators(float master_speed ) {
@@ -378,62 +778,398 @@ class ANIMartRIX {
 
     //***************************************************************
 
-    // Convert the 2 polar coordinates back to cartesian ones & also apply all
-    // 3d transitions. Calculate the noise value at this point based on the 5
-    // dimensional manipulation of the underlaying coordinates.
+    // A) enhance histogram (improve contrast) by setting the black and
+    // white point (low & high_limit) B) scale the result to a 0-255 range
+    // (assuming you want 8 bit color depth per rgb chanel) Here happens the
+    // contrast boosting & the brightness mapping
 
-    float render_value(render_parameters &animation) {
+    float scale_noise(float raw_noise_field_value, float low_limit,
+                      float high_limit) {
+        if (raw_noise_field_value < low_limit)
+            raw_noise_field_value = low_limit;
+        if (raw_noise_field_value > high_limit)
+            raw_noise_field_value = high_limit;
 
-        // convert polar coordinates back to cartesian ones
+        return map_float(raw_noise_field_value, low_limit, high_limit, 0, 255);
+    }
 
-        float newx = (animation.offset_x + animation.center_x -
-                      (FL_COS_F(animation.angle) * animation.dist)) *
-                     animation.scale_x;
-        float newy = (animation.offset_y + animation.center_y -
-                      (FL_SIN_F(animation.angle) * animation.dist)) *
-                     animation.scale_y;
-        float newz = (animation.offset_z + animation.z) * animation.scale_z;
+    // Layer engine ************************************************
 
-        // render noisevalue at this new cartesian point
+    // Starts a frame's layer list; returns layer 0 of n, all at defaults.
+    layer *begin_layers(int n) {
+        layer_count = n;
+        for (int l = 0; l < n; l++) {
+            layers[l] = layer();
+        }
+        return layers;
+    }
 
-        float raw_noise_field_value = pnoise(newx, newy, newz);
+    // Evaluates layers[0..layer_count) and writes every pixel through mix.
+    // The caches are resolved up front; after that every column range is
+    // independent, so parallel_for() may hand ranges to other workers.
+    void render_layers(const channel_mix &mix) {
+        for (int n = quality.layer_limit; n < layer_count; n++) {
+            layers[n].enabled = false;
+        }
+        for (int n = 0; n < layer_count; n++) {
+            const layer &l = layers[n];
+            if (!l.enabled) continue;
+            layer_plan &plan = plans[n];
+            plan.rot = l.twist_per_frame ? nullptr
+                                         : &static_rotation(n, l.angle_theta, l.angle_d);
+            plan.wave = l.wave_amp != 0 ? &distance_wave(n, l.wave_freq) : nullptr;
+            plan.turn = frame_angle(l.angle_0);
+            plan.wave_turn = frame_angle(plan.wave ? l.wave_phase : 0);
+        }
+        geometry_fields();
+        frame_mix = &mix;
+
+#ifdef AURORA_SIM
+        // the error statistics aren't thread-safe
+        if (sim::noiseError().enabled) {
+            render_columns(0, num_x);
+            return;
+        }
+#endif
+        const int stride = quality.column_stride;
+        parallel_for((num_x + stride - 1) / stride, render_columns_job, this);
+    }
 
-        // A) enhance histogram (improve contrast) by setting the black and
-        // white point (low & high_limit) B) scale the result to a 0-255 range
-        // (assuming you want 8 bit color depth per rgb chanel) Here happens the
-        // contrast boosting & the brightness mapping
+    // The range counts column groups, so a strided group never straddles two workers.
+    static void render_columns_job(void *ctx, int begin, int end) {
+        ANIMartRIX *self = static_cast<ANIMartRIX *>(ctx);
+        const int stride = self->quality.column_stride;
+        self->render_columns(begin * stride, std::min(end * stride, self->num_x));
+    }
 
-        if (raw_noise_field_value < animation.low_limit)
-            raw_noise_field_value = animation.low_limit;
-        if (raw_noise_field_value > animation.high_limit)
-            raw_noise_field_value = animation.high_limit;
+    // Splits [0, count) into ranges for job(ctx, begin, end). Runs it in one
+    // piece here; FastLEDANIMartRIX spreads it over its worker pool. Jobs
+    // must only write the pixels and buffer entries of their own range.
+    virtual void parallel_for(int count, void (*job)(void *, int, int),
+                              void *ctx) {
+        job(ctx, 0, count);
+    }
+
+    // Columns [x_begin, x_end) of the frame set up by render_layers().
+    // x_begin is a multiple of quality.column_stride.
+    void render_columns(int x_begin, int x_end) {
+        const int stride = quality.column_stride;
+        // one run over the whole range, or the first column of each group
+        const int run = stride == 1 ? x_end - x_begin : 1;
+        const int step = stride == 1 ? x_end - x_begin : stride;
+
+        for (int n = 0; n < layer_count; n++) {
+            if (!layers[n].enabled) continue;
+            for (int x = x_begin; x < x_end; x += step) {
+                render_layer_range(n, x * num_y, run * num_y);
+            }
+        }
+
+        if (direct_leds) {
+            mix_columns<true>(x_begin, x_end);
+        } else {
+            mix_columns<false>(x_begin, x_end);
+        }
+    }
+
+    // Noise values of layer n for pixels [first, first + count).
+    void render_layer_range(int n, int first, int count) {
+        const int pixels = num_x * num_y;
+        const layer &l = layers[n];
+        float *out_x = &buffers.x[n * pixels + first];
+        float *out_y = &buffers.y[n * pixels + first];
+        float *out_z = &buffers.z[n * pixels + first];
+        float *value = &buffers.value[n * pixels + first];
+        render_coordinates(l, plans[n], first, count, out_x, out_y, out_z);
+        pnoise_batch(out_x, out_y, out_z, value, count);
+#ifdef AURORA_SIM
+        if (sim::noiseError().enabled) record_noise_error(l, out_x, out_y, out_z, count);
+#endif
+        for (int k = 0; k < count; k++) {
+            value[k] = scale_noise(value[k], l.low_limit, l.high_limit);
+        }
+    }
+
+    // Channel mix for columns [x_begin, x_end). Direct: the store goes
+    // straight to direct_leds[direct_index[i]] with the colour order folded
+    // in; otherwise through setPixelColorInternal().
+    template <bool direct> void mix_columns(int x_begin, int x_end) {
+        const int pixels = num_x * num_y;
+        const channel_mix &mix = *frame_mix;
+        const float *dimmer = &fields.dimmer[0];
+        const float gain[3] = {mix.color_gains ? params.Red : 1.0f,
+                               mix.color_gains ? params.Green : 1.0f,
+                               mix.color_gains ? params.Blue : 1.0f};
+        const uint8_t hue_base = getTime() / 100;
+
+        for (int x = x_begin; x < x_end; x++) {
+            // layer values come from the evaluated column of x's group
+            const int source_x = x - x % quality.column_stride;
+            for (int y = 0; y < num_y; y++) {
+                const int i = x * num_y + y;
+                const int source = source_x * num_y + y;
+                rgb pixel;
+
+                float show[max_layers];
+                for (int n = 0; n < max_layers; n++) {
+                    show[n] = n < layer_count && layers[n].enabled
+                                  ? buffers.value[n * pixels + source]
+                                  : 0;
+                }
+
+                if (mix.hsv) {
+                    float hue = hue_base;
+                    for (int n = 0; n < layer_count; n++) hue += show[n];
+                    CRGB p = CRGB(CHSV(hue, 255, 255));
+                    pixel.red = p.red * gain[0];
+                    pixel.green = p.green * gain[1];
+                    pixel.blue = p.blue * gain[2];
+                } else {
+                    float channel[3];
+                    for (int c = 0; c < 3; c++) {
+                        float v = mix.bias[c];
+                        for (int n = 0; n < layer_count; n++) {
+                            v += mix.weight[c][n] * show[n];
+                        }
+                        if (mix.modifier[c] == MIX_RADIAL_DIMMER) v *= dimmer[i];
+                        else if (mix.modifier[c] == MIX_DISTANCE) v *= distance[i];
+                        channel[c] = v * gain[c];
+                    }
+                    pixel.red = channel[0];
+                    pixel.green = channel[1];
+                    pixel.blue = channel[2];
+
+                    pixel = rgb_sanity_check(pixel);
+                }
+
+                if (direct) {
+                    const uint8_t value[3] = {(uint8_t)pixel.red, (uint8_t)pixel.green,
+                                              (uint8_t)pixel.blue};
+                    CRGB &out = direct_leds[direct_index[i]];
+                    out.raw[0] = value[direct_order[0]];
+                    out.raw[1] = value[direct_order[1]];
+                    out.raw[2] = value[direct_order[2]];
+                } else {
+                    setPixelColorInternal(x, y, pixel);
+                }
+            }
+        }
+    }
 
-        float scaled_noise_value =
-            map_float(raw_noise_field_value, animation.low_limit,
-                      animation.high_limit, 0, 255);
+    // Noise-space coordinates of one layer for pixels [first, first + count).
+    void render_coordinates(const layer &l, const layer_plan &plan, int first,
+                            int count, float *out_x, float *out_y,
+                            float *out_z) {
+        const rotation_cache *rot = plan.rot; // null: angle computed per pixel
+        const rotation_cache *wave = plan.wave;
+        const frame_rotation &turn = plan.turn;
+        const frame_rotation &wave_turn = plan.wave_turn;
+        const float base_x = l.offset_x + noise_center;
+        const float base_y = l.offset_y + noise_center;
+        const float base_z = l.offset_z + l.z_0;
+
+        for (int k = 0; k < count; k++) {
+            const int i = first + k;
+            const float d = distance[i];
+            float dist = l.dist_0 + l.dist_d * d + l.dist_d2 * d * d;
+            float cos_angle, sin_angle;
+            // cos/sin(a + b) from the cached a and the per-frame b:
+            // cos(a + b) = cos a cos b - sin a sin b, sin(a + b) = sin a cos b + cos a sin b
+            if (wave) {
+                dist += l.wave_amp * (wave->sin_a[i] * wave_turn.cos_a +
+                                      wave->cos_a[i] * wave_turn.sin_a);
+            }
+            if (!rot) {
+                const float a = l.angle_theta * polar_theta[i] + l.angle_d * d;
+                cos_angle = FL_COS_F(a + turn.angle);
+                sin_angle = FL_SIN_F(a + turn.angle);
+            } else {
+                cos_angle = rot->cos_a[i] * turn.cos_a - rot->sin_a[i] * turn.sin_a;
+                sin_angle = rot->sin_a[i] * turn.cos_a + rot->cos_a[i] * turn.sin_a;
+            }
+            out_x[k] = (base_x - cos_angle * dist) * l.scale_x;
+            out_y[k] = (base_y - sin_angle * dist) * l.scale_y;
+            out_z[k] = (base_z + l.z_d * d) * l.scale_z;
+        }
+    }
 
-        return scaled_noise_value;
+#ifdef AURORA_SIM
+    void record_noise_error(const layer &l, const float *xs, const float *ys,
+                            const float *zs, int n) {
+        sim::NoiseError &stats = sim::noiseError();
+        for (int k = 0; k < n; k++) {
+            const float x = xs[k], y = ys[k], z = zs[k];
+            float reference = pnoise_float(x, y, z);
+            float fixed = pnoise_q16(to_q16(x), to_q16(y), to_q16(z)) * (1.0f / 65536);
+            double err = fabs((double)fixed - reference);
+            double levels = fabs((double)scale_noise(fixed, l.low_limit, l.high_limit) -
+                                 scale_noise(reference, l.low_limit, l.high_limit));
+            if (stats.samples == 0) stats.minCoord = stats.maxCoord = x;
+            stats.minCoord = fminf(stats.minCoord, fminf(x, fminf(y, z)));
+            stats.maxCoord = fmaxf(stats.maxCoord, fmaxf(x, fmaxf(y, z)));
+            stats.maxAbs = fmax(stats.maxAbs, err);
+            stats.maxLevels = fmax(stats.maxLevels, levels);
+            stats.sumAbs += err;
+            stats.samples++;
+        }
     }
+#endif
 
     // given a static polar origin we can precalculate the polar coordinates
     
     void render_polar_lookup_table(float cx, float cy) {
 
-        polar_theta.resize(num_x, fl::HeapVector<float>(num_y, 0.0f));
-        distance.resize(num_x, fl::HeapVector<float>(num_y, 0.0f));
+        allocate_polar_tables(num_x * num_y);
+        fill_polar_tables(polar_theta, distance, num_x, num_y, cx, cy);
+        invalidate_geometry_caches();
+    }
 
-        for (int xx = 0; xx < num_x; xx++) {
-            for (int yy = 0; yy < num_y; yy++) {
+    static void fill_polar_tables(float *theta, float *dist, int w, int h,
+                                  float cx, float cy) {
+        int i = 0;
+        for (int xx = 0; xx < w; xx++) {
+            for (int yy = 0; yy < h; yy++) {
 
                 float dx = xx - cx;
                 float dy = yy - cy;
 
-                distance[xx][yy] = hypotf(dx, dy);
-                polar_theta[xx][yy] = atan2f(dy, dx);
+                dist[i] = hypotf(dx, dy);
+                theta[i] = atan2f(dy, dx);
+                i++;
             }
         }
     }
 
+    // Centred polar tables for num_x * num_y, from the shared set for this
+    // size when there is one, so switching effects or adding a second
+    // ANIMartRIX of the same size never recomputes them.
+    void bind_polar_tables() {
+        const float cx = (num_x / 2) - 0.5;
+        const float cy = (num_y / 2) - 0.5;
+        const polar_geometry *shared = shared_polar_geometry(num_x, num_y, cx, cy);
+        if (!shared) {
+            render_polar_lookup_table(cx, cy);
+            return;
+        }
+        polar_storage.clear();
+        polar_theta = shared->polar_theta;
+        distance = shared->distance;
+        polar_size = num_x * num_y;
+        polar_shared = true;
+        invalidate_geometry_caches();
+    }
+
+    // Polar tables owned elsewhere (e.g. by a loaded LED layout), num_x * num_y
+    // entries in render order. Like the shared ones they're never written.
+    void use_polar_tables(float *theta, float *dist) {
+        polar_storage.clear();
+        polar_theta = theta;
+        distance = dist;
+        polar_size = num_x * num_y;
+        polar_shared = true;
+        invalidate_geometry_caches();
+    }
+
+    static const polar_geometry *shared_polar_geometry(int w, int h, float cx,
+                                                       float cy) {
+        static polar_geometry sets[max_polar_geometries];
+        for (polar_geometry &g : sets) {
+            if (g.num_x == w && g.num_y == h) return &g;
+        }
+        for (polar_geometry &g : sets) {
+            if (g.num_x != 0) continue;
+            align_polar_storage(g.storage, w * h, g.polar_theta, g.distance);
+            fill_polar_tables(g.polar_theta, g.distance, w, h, cx, cy);
+            g.num_x = w;
+            g.num_y = h;
+            return &g;
+        }
+        return nullptr; // all sets taken; the caller builds its own
+    }
+
+    // new geometry, so every cached layer angle and field is stale
+    void invalidate_geometry_caches() {
+        for (int slot = 0; slot < num_rotation_caches; slot++) {
+            rotation[slot].valid = false;
+        }
+        for (int slot = 0; slot < max_layers; slot++) {
+            waves[slot].valid = false;
+        }
+        fields.valid = false;
+    }
+
+    // Static layer angle k_theta * polar_theta + k_dist * distance for every
+    // pixel, with its cos/sin. Cheap when nothing changed since the last frame.
+    const rotation_cache &static_rotation(int slot, float k_theta, float k_dist) {
+        return build_rotation(rotation[slot], k_theta, k_dist);
+    }
+
+    // sin/cos(freq * distance), for the distance wave of layer `slot`
+    const rotation_cache &distance_wave(int slot, float freq) {
+        return build_rotation(waves[slot], 0, freq);
+    }
+
+    const rotation_cache &build_rotation(rotation_cache &cache, float k_theta,
+                                         float k_dist) {
+        const int pixels = num_x * num_y;
+        if (cache.valid && cache.k_theta == k_theta && cache.k_dist == k_dist &&
+            (int)cache.cos_a.size() == pixels) {
+            return cache;
+        }
+        cache.cos_a.resize(pixels, 0.0f);
+        cache.sin_a.resize(pixels, 0.0f);
+        for (int i = 0; i < pixels; i++) {
+            float a = k_theta * polar_theta[i] + k_dist * distance[i];
+            cache.cos_a[i] = FL_COS_F(a);
+            cache.sin_a[i] = FL_SIN_F(a);
+        }
+        cache.k_theta = k_theta;
+        cache.k_dist = k_dist;
+        cache.valid = true;
+        return cache;
+    }
+
+    const static_fields &geometry_fields() {
+        if (fields.valid && fields.generation == geometryGeneration) {
+            return fields;
+        }
+        const int pixels = num_x * num_y;
+        fields.dimmer.resize(pixels, 0.0f);
+        const float radius = radial_filter_radius * params.Radius;
+        for (int i = 0; i < pixels; i++) {
+            fields.dimmer[i] = radialFilterFactor(radius, distance[i], params.Edge);
+        }
+        fields.generation = geometryGeneration;
+        fields.valid = true;
+        return fields;
+    }
+
+    frame_rotation frame_angle(float angle) {
+        return {angle, FL_COS_F(angle), FL_SIN_F(angle)};
+    }
+
+    // Only reallocates when the pixel count changes or the current tables
+    // are the shared (read-only) ones.
+    void allocate_polar_tables(int pixels) {
+        if (pixels == polar_size && polar_theta && !polar_shared) return;
+
+        align_polar_storage(polar_storage, pixels, polar_theta, distance);
+        polar_size = pixels;
+        polar_shared = false;
+    }
+
+    static void align_polar_storage(fl::HeapVector<float> &storage, int pixels,
+                                    float *&theta, float *&dist) {
+        const int padded = (pixels + 3) & ~3; // keep the second table aligned too
+        storage.clear();
+        storage.resize(2 * padded + 4, 0.0f);
+
+        uintptr_t base = reinterpret_cast<uintptr_t>(storage.data());
+        float *aligned = reinterpret_cast<float *>((base + 15) & ~uintptr_t(15));
+        theta = aligned;
+        dist = aligned + padded;
+    }
+
     // float mapping maintaining 32 bit precision
     // we keep values with high resolution for potential later usage
 
@@ -483,680 +1219,428 @@ class ANIMartRIX {
 
     void Polar_Waves() {
 
-        timings.master_speed = 0.5 * cSpeed;
+        timings.master_speed = 0.5 * params.Speed;
 
-        timings.ratio[0] = 0.0025 + cRatBase/100; 
-        timings.ratio[1] = 0.0027 + cRatBase/100 * cRatDiff;
-        timings.ratio[2] = 0.0031 + cRatBase/100 * 2 * cRatDiff;
+        timings.ratio[0] = 0.0025 + params.RatBase/100; 
+        timings.ratio[1] = 0.0027 + params.RatBase/100 * params.RatDiff;
+        timings.ratio[2] = 0.0031 + params.RatBase/100 * 2 * params.RatDiff;
 
         calculate_oscillators(timings);
 
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.dist = distance[x][y] * cZoom;
-                animation.angle =
-                    polar_theta[x][y] * cAngle
-                    - animation.dist * 0.1
-                    + move.radial[0];
-                    // can add noise_angle for non-periodic rotation
-                    // add multiple noise_angle for additional variation
-                animation.z = ((animation.dist * 1.5) - 10 * move.linear[0]) * cZ;
-                animation.scale_x = 0.15 * cScale;
-                animation.scale_y = 0.15 * cScale;
-                animation.offset_x = move.linear[0];
-                show1 = { Layer1 ? render_value(animation) : 0};
-                
-                animation.angle =
-                    polar_theta[x][y] * cAngle
-                    - animation.dist * 0.1 * cTwist
-                    + move.radial[1];
-                animation.z = ((animation.dist * 1.5) - 10 * move.linear[1]) * cZ;
-                animation.offset_x = move.linear[1];
-                show2 = { Layer2 ? render_value(animation) : 0 };
-
-                animation.angle =
-                    polar_theta[x][y] * cAngle
-                    - animation.dist * 0.1 * cTwist
-                    + move.radial[2];
-                animation.z = ((animation.dist * 1.5) - 10 * move.linear[2]) * cZ;
-                animation.offset_x = move.linear[2];
-                show3 = { Layer3 ? render_value(animation) : 0 };
-                
-                //float radial = (radius - distance[x][y]) / distance[x][y];
-                //float radialFilter = (radius - distance[x][y]) / distance[x][y];
-                
-                float radius = radial_filter_radius * cRadius;
-                radialFilterFalloff = cEdge;
-                radialDimmer = radialFilterFactor(radius, distance[x][y], radialFilterFalloff);
-               
-                pixel.red = show1 * cRed * radialDimmer; 
-                pixel.green = show2 * cGreen * radialDimmer; 
-                pixel.blue = show3 * cBlue * radialDimmer;
-
-                pixel = rgb_sanity_check(pixel);
-                setPixelColorInternal(x, y, pixel);
-
-            }
+        layer *l = begin_layers(3);
+        const bool enabled[3] = {params.Layer1, params.Layer2, params.Layer3};
+        for (int n = 0; n < 3; n++) {
+            l[n].enabled = enabled[n];
+            l[n].dist_d = params.Zoom;
+            l[n].angle_theta = params.Angle;
+            l[n].angle_d = -0.1f * params.Zoom * (n == 0 ? 1 : params.Twist);
+            l[n].angle_0 = move.radial[n];
+                // can add noise_angle for non-periodic rotation
+                // add multiple noise_angle for additional variation
+            l[n].z_d = 1.5f * params.Zoom * params.Z;
+            l[n].z_0 = -10 * move.linear[n] * params.Z;
+            l[n].scale_x = 0.15 * params.Scale;
+            l[n].scale_y = 0.15 * params.Scale;
+            l[n].offset_x = move.linear[n];
         }
+
+        static const channel_mix mix = {
+            {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
+            {0, 0, 0},
+            {MIX_RADIAL_DIMMER, MIX_RADIAL_DIMMER, MIX_RADIAL_DIMMER},
+            true, false};
+        render_layers(mix);
     }
 
     //*******************************************************************************
 
     void Spiralus() {
 
-        timings.master_speed = 0.0011 * cSpeed;
+        timings.master_speed = 0.0011 * params.Speed;
         
-        timings.ratio[0] = 1.5 + cRatBase * 2 * cRatDiff;       
-        timings.ratio[1] = 2.3 + cRatBase * 2 * cRatDiff;
-        timings.ratio[2] = 3 + cRatBase * 2 * cRatDiff;
-        timings.ratio[3] = 0.05 + cRatBase/10 ;
-        timings.ratio[4] = 0.2 + cRatBase/10 ;
-        timings.ratio[5] = 0.03 + cRatBase/10 ;
-        timings.ratio[6] = 0.025 + cRatBase/10 ;
-        timings.ratio[7] = 0.021 + cRatBase/10 ;
-        timings.ratio[8] = 0.027 + cRatBase/10 ;
+        timings.ratio[0] = 1.5 + params.RatBase * 2 * params.RatDiff;       
+        timings.ratio[1] = 2.3 + params.RatBase * 2 * params.RatDiff;
+        timings.ratio[2] = 3 + params.RatBase * 2 * params.RatDiff;
+        timings.ratio[3] = 0.05 + params.RatBase/10 ;
+        timings.ratio[4] = 0.2 + params.RatBase/10 ;
+        timings.ratio[5] = 0.03 + params.RatBase/10 ;
+        timings.ratio[6] = 0.025 + params.RatBase/10 ;
+        timings.ratio[7] = 0.021 + params.RatBase/10 ;
+        timings.ratio[8] = 0.027 + params.RatBase/10 ;
         
         timings.offset[0] = 0 ;
-        timings.offset[1] = 100 * cOffBase;
-        timings.offset[2] = 200 * cOffBase * cOffDiff;
-        timings.offset[3] = 300 * cOffBase * 1.25 * cOffDiff;
-        timings.offset[4] = 400 * cOffBase * 1.5 * cOffDiff;
-        timings.offset[5] = 500 * cOffBase * 1.75 * cOffDiff;
-        timings.offset[6] = 600 * cOffBase * 2 * cOffDiff;
-
-        calculate_oscillators(timings); 
-
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.dist = distance[x][y] * cZoom;
-                animation.angle = 
-                    2 * polar_theta[x][y] * cAngle  
-                    + move.noise_angle[5] 
-                    + move.directional[3] * move.noise_angle[6] * animation.dist / 10 * cTwist;
-                animation.scale_x = 0.08 * cScale;
-                animation.scale_y = 0.08 * cScale;
-                animation.scale_z = 0.02; 
-                animation.offset_y = -move.linear[0];
-                animation.offset_x = 0;
-                animation.offset_z = 0;
-                animation.z = move.linear[1] * cZ;
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.angle = 
-                    2 * polar_theta[x][y] * cAngle
-                    + move.noise_angle[7]
-                    + move.directional[5] * move.noise_angle[8] * animation.dist / 10 * cTwist;
-                animation.offset_y = -move.linear[1];
-                animation.z = move.linear[2] * cZ;
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                animation.angle = 
-                    2 * polar_theta[x][y] * cAngle
-                    + move.noise_angle[6] 
-                    + move.directional[6] * move.noise_angle[7] * animation.dist / 10 * cTwist;
-                animation.offset_y = move.linear[2];
-                animation.z = move.linear[0] * cZ;
-                show3 = { Layer3 ? render_value(animation) : 0};
-
-                float radius = radial_filter_radius * cRadius;
-                radialFilterFalloff = cEdge;
-                //radialDimmer = radialFilterFactor(radius, distance[x][y], radialFilterFalloff);
-                radialDimmer = 1;   
-
-                pixel.red =     (show1 + show2) * cRed * radialDimmer;
-                pixel.green =   (show1 - show2) * cGreen * radialDimmer;
-                pixel.blue =    (show3 - show1) * cBlue * radialDimmer;
-
-                pixel = rgb_sanity_check(pixel);
-                setPixelColorInternal(x, y, pixel);
-            }
+        timings.offset[1] = 100 * params.OffBase;
+        timings.offset[2] = 200 * params.OffBase * params.OffDiff;
+        timings.offset[3] = 300 * params.OffBase * 1.25 * params.OffDiff;
+        timings.offset[4] = 400 * params.OffBase * 1.5 * params.OffDiff;
+        timings.offset[5] = 500 * params.OffBase * 1.75 * params.OffDiff;
+        timings.offset[6] = 600 * params.OffBase * 2 * params.OffDiff;
+
+        calculate_oscillators(timings, 0b111100000); // reads noise_angle 5, 6, 7, 8
+
+        layer *l = begin_layers(3);
+        const bool enabled[3] = {params.Layer1, params.Layer2, params.Layer3};
+        // n: noise_angle rotation, twist = directional * noise_angle
+        const float rotate[3] = {move.noise_angle[5], move.noise_angle[7], move.noise_angle[6]};
+        const float twist[3] = {move.directional[3] * move.noise_angle[6],
+                                move.directional[5] * move.noise_angle[8],
+                                move.directional[6] * move.noise_angle[7]};
+        const float offset_y[3] = {-move.linear[0], -move.linear[1], move.linear[2]};
+        const float z[3] = {move.linear[1], move.linear[2], move.linear[0]};
+        for (int n = 0; n < 3; n++) {
+            l[n].enabled = enabled[n];
+            l[n].dist_d = params.Zoom;
+            l[n].angle_theta = 2 * params.Angle;
+            l[n].angle_d = twist[n] * params.Zoom / 10 * params.Twist;
+            l[n].twist_per_frame = true;
+            l[n].angle_0 = rotate[n];
+            l[n].scale_x = 0.08 * params.Scale;
+            l[n].scale_y = 0.08 * params.Scale;
+            l[n].scale_z = 0.02;
+            l[n].offset_y = offset_y[n];
+            l[n].z_0 = z[n] * params.Z;
         }
+
+        static const channel_mix mix = {
+            {{1, 1, 0}, {1, -1, 0}, {-1, 0, 1}},
+            {0, 0, 0},
+            {MIX_PLAIN, MIX_PLAIN, MIX_PLAIN},
+            true, false};
+        render_layers(mix);
     }
- 
+
     //*******************************************************************************
 
     void Caleido1() {
 
-        timings.master_speed = 0.003 * cSpeed;
+        timings.master_speed = 0.003 * params.Speed;
         
-        timings.ratio[0] = 0.02 + cRatBase/10  ;
-        timings.ratio[1] = 0.03 + cRatBase/10 * cRatDiff;
-        timings.ratio[2] = 0.04 + cRatBase/10 * 1.5 * cRatDiff;
-        timings.ratio[3] = 0.05 + cRatBase/10 * 2 * cRatDiff;
-        timings.ratio[4] = 0.6 + cRatBase/5 ;
+        timings.ratio[0] = 0.02 + params.RatBase/10  ;
+        timings.ratio[1] = 0.03 + params.RatBase/10 * params.RatDiff;
+        timings.ratio[2] = 0.04 + params.RatBase/10 * 1.5 * params.RatDiff;
+        timings.ratio[3] = 0.05 + params.RatBase/10 * 2 * params.RatDiff;
+        timings.ratio[4] = 0.6 + params.RatBase/5 ;
         
         timings.offset[0] = 0;
-        timings.offset[1] = 100 * cOffBase;
-        timings.offset[2] = 200 * cOffBase * cOffDiff;
-        timings.offset[3] = 300 * cOffBase * 1.25 * cOffDiff;
-        timings.offset[4] = 400 * cOffBase * 1.5 * cOffDiff;
-
-        calculate_oscillators(timings); 
-
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.dist = distance[x][y] * cZoom * (2 + move.directional[0]) / 3;
-                animation.angle = 
-                    3 * polar_theta[x][y] * cAngle
-                    + 3 * move.noise_angle[0] 
-                    + move.radial[4];
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.scale_z = 0.1;
-                animation.offset_y = 2 * move.linear[0];
-                animation.offset_x = 0;
-                animation.offset_z = 0;
-                animation.z = move.linear[0] * cZ;
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.dist = distance[x][y] * cZoom * (2 + move.directional[1]) / 3;
-                animation.angle = 
-                    4 * polar_theta[x][y] * cAngle
-                    + 3 * move.noise_angle[1] 
-                    + move.radial[4];
-                animation.offset_x = 2 * move.linear[1];
-                animation.z = move.linear[1] * cZ;
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                animation.dist = distance[x][y] * cZoom * (2 + move.directional[2]) / 3;
-                animation.angle = 
-                    5 * polar_theta[x][y] * cAngle
-                    + 3 * move.noise_angle[2]
-                    + move.radial[4];
-                animation.offset_y = 2 * move.linear[2];
-                animation.z = move.linear[2] * cZ;
-                show3 = { Layer3 ? render_value(animation) : 0};
-
-                animation.dist = distance[x][y] * cZoom * (2 + move.directional[3]) / 3;
-                animation.angle = 
-                    4 * polar_theta[x][y] * cAngle
-                    + 3 * move.noise_angle[3]
-                    + move.radial[4];
-                animation.offset_x = 2 * move.linear[3];
-                animation.z = move.linear[3] * cZ;
-                show4 = { Layer4 ? render_value(animation) : 0};
-
-                pixel.red = show1 * cRed;
-                pixel.green = (show3 * distance[x][y] / 10) * cGreen;
-                pixel.blue = ((show2 + show4) / 2) * cBlue;
-
-                pixel = rgb_sanity_check(pixel);
-
-                setPixelColorInternal(x, y, pixel);
-            }
+        timings.offset[1] = 100 * params.OffBase;
+        timings.offset[2] = 200 * params.OffBase * params.OffDiff;
+        timings.offset[3] = 300 * params.OffBase * 1.25 * params.OffDiff;
+        timings.offset[4] = 400 * params.OffBase * 1.5 * params.OffDiff;
+
+        calculate_oscillators(timings, 0b1111); // reads noise_angle 0, 1, 2, 3
+
+        layer *l = begin_layers(4);
+        const bool enabled[4] = {params.Layer1, params.Layer2, params.Layer3, params.Layer4};
+        const float petals[4] = {3, 4, 5, 4};
+        // each layer moves one offset axis, the other keeps the previous layer's
+        const float offset_x[4] = {0, 2 * move.linear[1], 2 * move.linear[1], 2 * move.linear[3]};
+        const float offset_y[4] = {2 * move.linear[0], 2 * move.linear[0], 2 * move.linear[2], 2 * move.linear[2]};
+        for (int n = 0; n < 4; n++) {
+            l[n].enabled = enabled[n];
+            l[n].dist_d = params.Zoom * (2 + move.directional[n]) / 3;
+            l[n].angle_theta = petals[n] * params.Angle;
+            l[n].angle_0 = 3 * move.noise_angle[n] + move.radial[4];
+            l[n].scale_x = 0.1 * params.Scale;
+            l[n].scale_y = 0.1 * params.Scale;
+            l[n].offset_x = offset_x[n];
+            l[n].offset_y = offset_y[n];
+            l[n].z_0 = move.linear[n] * params.Z;
         }
+
+        static const channel_mix mix = {
+            {{1, 0, 0, 0}, {0, 0, 0.1, 0}, {0, 0.5, 0, 0.5}},
+            {0, 0, 0},
+            {MIX_PLAIN, MIX_DISTANCE, MIX_PLAIN},
+            true, false};
+        render_layers(mix);
     }
 
     //*******************************************************************************
 
     void Cool_Waves() {
 
-        timings.master_speed = 0.01 * cSpeed; 
+        timings.master_speed = 0.01 * params.Speed; 
         
-        timings.ratio[0] = 2  + cRatBase; 
-        timings.ratio[1] = 2.1 + cRatBase * cRatDiff;
-        timings.ratio[2] = 1.2 + cRatBase * cRatDiff;;
+        timings.ratio[0] = 2  + params.RatBase; 
+        timings.ratio[1] = 2.1 + params.RatBase * params.RatDiff;
+        timings.ratio[2] = 1.2 + params.RatBase * params.RatDiff;;
 
-        timings.offset[1] = 100 * cOffBase;
-        timings.offset[2] = 200 * cOffBase * cOffDiff;
-        timings.offset[3] = 300 * cOffBase * 1.5 * cOffDiff;
+        timings.offset[1] = 100 * params.OffBase;
+        timings.offset[2] = 200 * params.OffBase * params.OffDiff;
+        timings.offset[3] = 300 * params.OffBase * 1.5 * params.OffDiff;
 
         calculate_oscillators(timings);
 
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.angle = polar_theta[x][y] *cAngle;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.scale_z = 0.1;
-                animation.dist = distance[x][y] * cZoom;
-                animation.offset_y = 0;
-                animation.offset_x = 0;
-                animation.z = (2 * distance[x][y] - move.linear[0]) * cZ;
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.angle = polar_theta[x][y];
-                animation.z = (2 * distance[x][y] - move.linear[1]) * cZ;
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                pixel.red = show1;
-                pixel.green = 0;
-                pixel.blue = show2;
-
-                pixel = rgb_sanity_check(pixel);
-
-                setPixelColorInternal(x, y, pixel);
-            }
+        layer *l = begin_layers(2);
+        const bool enabled[2] = {params.Layer1, params.Layer2};
+        for (int n = 0; n < 2; n++) {
+            l[n].enabled = enabled[n];
+            l[n].dist_d = params.Zoom;
+            l[n].angle_theta = n == 0 ? params.Angle : 1;
+            l[n].scale_x = 0.1 * params.Scale;
+            l[n].scale_y = 0.1 * params.Scale;
+            l[n].z_d = 2 * params.Z;
+            l[n].z_0 = -move.linear[n] * params.Z;
         }
+
+        static const channel_mix mix = {
+            {{1, 0}, {0, 0}, {0, 1}},
+            {0, 0, 0},
+            {MIX_PLAIN, MIX_PLAIN, MIX_PLAIN},
+            false, false};
+        render_layers(mix);
     }
- 
+
     //*******************************************************************************
 
     void Chasing_Spirals() {
 
-        timings.master_speed = 0.01 * cSpeed; 
+        timings.master_speed = 0.01 * params.Speed; 
 
-        timings.ratio[0] = 0.1 +  cRatBase/10;
-        timings.ratio[1] = 0.13 + cRatBase/10 * cRatDiff ;
-        timings.ratio[2] = 0.16 + cRatBase/10 * 2 * cRatDiff;
+        timings.ratio[0] = 0.1 +  params.RatBase/10;
+        timings.ratio[1] = 0.13 + params.RatBase/10 * params.RatDiff ;
+        timings.ratio[2] = 0.16 + params.RatBase/10 * 2 * params.RatDiff;
 
-        timings.offset[1] = 10 * cOffBase;
-        timings.offset[2] = 20 * cOffBase * cOffDiff;
-        timings.offset[3] = 30 * cOffBase * 2 * cOffDiff;
+        timings.offset[1] = 10 * params.OffBase;
+        timings.offset[2] = 20 * params.OffBase * params.OffDiff;
+        timings.offset[3] = 30 * params.OffBase * 2 * params.OffDiff;
 
         calculate_oscillators(timings); 
 
-        float Twister = cAngle * move.directional[0];
-
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.dist = distance[x][y] / 4 * cZoom;
-                animation.angle =
-                    3 * polar_theta[x][y] * cAngle
-                    + move.radial[0] 
-                    - distance[x][y]; // * Twister;
-                animation.scale_z = .1;
-                animation.scale_y = .1 * cScale;
-                animation.scale_x = .1 * cScale;
-                animation.offset_x = move.linear[0];
-                animation.offset_y = 0;
-                animation.offset_z = 0;
-                animation.z = 0;
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.angle =
-                    3 * polar_theta[x][y] * cAngle
-                    + move.radial[1] 
-                    - distance[x][y] * Twister;
-                animation.offset_x = move.linear[1];
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                animation.angle =
-                    3 * polar_theta[x][y] * cAngle
-                    + move.radial[2] 
-                    - distance[x][y] * Twister;
-                animation.offset_x = move.linear[2];
-                show3 = { Layer3 ? render_value(animation) : 0};
-
-                float radius = radial_filter_radius * cRadius;
-                radialFilterFalloff = cEdge;
-                radialDimmer = radialFilterFactor(radius, distance[x][y], radialFilterFalloff);
-
-                pixel.red =     (3 * show1 * cRed) * radialDimmer;
-                pixel.green =   (show2 * cGreen) / 2 * radialDimmer;
-                pixel.blue =    (show3 * cBlue) / 4 * radialDimmer;
-
-                pixel = rgb_sanity_check(pixel);
-
-                setPixelColorInternal(x, y, pixel);
-            }
+        float Twister = params.Angle * move.directional[0];
+
+        layer *l = begin_layers(3);
+        const bool enabled[3] = {params.Layer1, params.Layer2, params.Layer3};
+        for (int n = 0; n < 3; n++) {
+            l[n].enabled = enabled[n];
+            l[n].dist_d = params.Zoom / 4;
+            l[n].angle_theta = 3 * params.Angle;
+            l[n].angle_d = n == 0 ? -1 : -Twister;
+            l[n].twist_per_frame = n != 0;
+            l[n].angle_0 = move.radial[n];
+            l[n].scale_x = .1 * params.Scale;
+            l[n].scale_y = .1 * params.Scale;
+            l[n].offset_x = move.linear[n];
         }
+
+        static const channel_mix mix = {
+            {{3, 0, 0}, {0, 0.5, 0}, {0, 0, 0.25}},
+            {0, 0, 0},
+            {MIX_RADIAL_DIMMER, MIX_RADIAL_DIMMER, MIX_RADIAL_DIMMER},
+            true, false};
+        render_layers(mix);
     }
 
     //*******************************************************************************
 
-     void Complex_Kaleido_6() {
-
-        timings.master_speed = 0.01 * cSpeed; 
-
-        timings.ratio[0] = 0.025 + cRatBase/10; 
-        timings.ratio[1] = 0.027 + cRatBase/10 * cRatDiff;
-        timings.ratio[2] = 0.031 + cRatBase/10 * 1.2 * cRatDiff;
-        timings.ratio[3] = 0.033 + cRatBase/10 * 1.4 * cRatDiff;
-        timings.ratio[4] = 0.037 + cRatBase/10 * 1.6 * cRatDiff;
-        timings.ratio[5] = 0.038 + cRatBase/10 * 1.8 * cRatDiff;
-        timings.ratio[6] = 0.041 + cRatBase/10 * 2 * cRatDiff;
-
-        calculate_oscillators(timings);
-
-        float Twister = cAngle * move.directional[0] * cTwist / 10;
-
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.dist = distance[x][y] * cZoom;
-                animation.angle = 
-                    4 * polar_theta[x][y] * cAngle 
-                    + 16 * move.radial[0]
-                    - distance[x][y] * Twister * move.noise_angle[5] 
-                    + move.directional[3]; 
-                animation.z = 5 * cZ;
-                animation.scale_x = 0.06 * cScale;
-                animation.scale_y = 0.06 * cScale;
-                animation.offset_z = -10 * move.linear[0];
-                animation.offset_y = 10 * move.noise_angle[0];
-                animation.offset_x = 10 * move.noise_angle[4];
-                animation.low_limit = 0;
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.angle = 
-                    16 * polar_theta[x][y] * cAngle
-                    + 16 * move.radial[1];
-                animation.z = 500 * cZ;
-                animation.scale_x = 0.06 * cScale;;
-                animation.scale_y = 0.06 * cScale;;
-                animation.offset_z = -10 * move.linear[1];
-                animation.offset_y = 10 * move.noise_angle[1];
-                animation.offset_x = 10 * move.noise_angle[3];
-                animation.low_limit = 0;
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                // float radius = radial_filter_radius;   // radius of a radial
-                // brightness filter float radial =
-                // (radius-distance[x][y])/distance[x][y];
-                
-                float radius = radial_filter_radius * cRadius;
-                radialFilterFalloff = cEdge;
-                radialDimmer = radialFilterFactor(radius, distance[x][y], radialFilterFalloff);
-
-                pixel.red = show1 * radialDimmer;
-                pixel.green = 0 * radialDimmer;
-                pixel.blue = show2 * radialDimmer;
-
-                pixel = rgb_sanity_check(pixel);
-
-                setPixelColorInternal(x, y, pixel);
-            }
-        }
+    void Complex_Kaleido_6() {
+
+        timings.master_speed = 0.01 * params.Speed; 
+
+        timings.ratio[0] = 0.025 + params.RatBase/10; 
+        timings.ratio[1] = 0.027 + params.RatBase/10 * params.RatDiff;
+        timings.ratio[2] = 0.031 + params.RatBase/10 * 1.2 * params.RatDiff;
+        timings.ratio[3] = 0.033 + params.RatBase/10 * 1.4 * params.RatDiff;
+        timings.ratio[4] = 0.037 + params.RatBase/10 * 1.6 * params.RatDiff;
+        timings.ratio[5] = 0.038 + params.RatBase/10 * 1.8 * params.RatDiff;
+        timings.ratio[6] = 0.041 + params.RatBase/10 * 2 * params.RatDiff;
+
+        calculate_oscillators(timings, 0b111011); // reads noise_angle 0, 1, 3, 4, 5
+
+        float Twister = params.Angle * move.directional[0] * params.Twist / 10;
+
+        layer *l = begin_layers(2);
+
+        l[0].enabled = params.Layer1;
+        l[0].dist_d = params.Zoom;
+        l[0].angle_theta = 4 * params.Angle;
+        l[0].angle_d = -Twister * move.noise_angle[5];
+        l[0].twist_per_frame = true;
+        l[0].angle_0 = 16 * move.radial[0] + move.directional[3];
+        l[0].z_0 = 5 * params.Z;
+        l[0].scale_x = 0.06 * params.Scale;
+        l[0].scale_y = 0.06 * params.Scale;
+        l[0].offset_z = -10 * move.linear[0];
+        l[0].offset_y = 10 * move.noise_angle[0];
+        l[0].offset_x = 10 * move.noise_angle[4];
+
+        l[1].enabled = params.Layer2;
+        l[1].dist_d = params.Zoom;
+        l[1].angle_theta = 16 * params.Angle;
+        l[1].angle_0 = 16 * move.radial[1];
+        l[1].z_0 = 500 * params.Z;
+        l[1].scale_x = 0.06 * params.Scale;
+        l[1].scale_y = 0.06 * params.Scale;
+        l[1].offset_z = -10 * move.linear[1];
+        l[1].offset_y = 10 * move.noise_angle[1];
+        l[1].offset_x = 10 * move.noise_angle[3];
+
+        static const channel_mix mix = {
+            {{1, 0}, {0, 0}, {0, 1}},
+            {0, 0, 0},
+            {MIX_RADIAL_DIMMER, MIX_RADIAL_DIMMER, MIX_RADIAL_DIMMER},
+            false, false};
+        render_layers(mix);
     }
 
     //*******************************************************************************
 
     void Water() {
 
-        timings.master_speed = 0.037 * cSpeed;
+        timings.master_speed = 0.037 * params.Speed;
 
-        timings.ratio[0] = 0.025 + cRatBase/10; 
-        timings.ratio[1] = 0.027 + cRatBase/10 * cRatDiff;
-        timings.ratio[2] = 0.031 + cRatBase/10 * 1.25* cRatDiff;
-        timings.ratio[3] = 0.033 + cRatBase/10 * 1.5 * cRatDiff; 
-        timings.ratio[4] = 0.037 + cRatBase/10 * 1.75 * cRatDiff;
-        timings.ratio[5] = 0.1 + cRatBase/5;
-        timings.ratio[6] = 0.41 + cRatBase/5;
+        timings.ratio[0] = 0.025 + params.RatBase/10; 
+        timings.ratio[1] = 0.027 + params.RatBase/10 * params.RatDiff;
+        timings.ratio[2] = 0.031 + params.RatBase/10 * 1.25* params.RatDiff;
+        timings.ratio[3] = 0.033 + params.RatBase/10 * 1.5 * params.RatDiff; 
+        timings.ratio[4] = 0.037 + params.RatBase/10 * 1.75 * params.RatDiff;
+        timings.ratio[5] = 0.1 + params.RatBase/5;
+        timings.ratio[6] = 0.41 + params.RatBase/5;
 
         calculate_oscillators(timings);
 
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.dist =
-                    distance[x][y] * cZoom +
-                    4 * FL_SIN_F(move.directional[5] * PI ) +
-                    4 * FL_COS_F(move.directional[6] * PI );
-                animation.angle = 1 * polar_theta[x][y] * cAngle ;
-                animation.z = 5 * cZ;
-                animation.scale_x = 0.06 * cScale;
-                animation.scale_y = 0.06 * cScale;
-                animation.offset_z = -10 * move.linear[0];
-                animation.offset_y = 10;
-                animation.offset_x = 10;
-                animation.low_limit = 0;
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.dist = 
-                    (10 + move.directional[0]) * FL_SIN_F(-move.radial[5] + 
-                    move.radial[0] + (distance[x][y] / (3)));
-                animation.angle = 1 * polar_theta[x][y] * cAngle ;
-                animation.z = 5 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = -10;
-                animation.offset_y = 20 * move.linear[0];
-                animation.offset_x = 10;
-                animation.low_limit = 0;
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                animation.dist = 
-                    (10 + move.directional[1]) * FL_SIN_F(-move.radial[5] + 
-                    move.radial[1] + (distance[x][y] / (3)));
-                animation.angle = 1 * polar_theta[x][y] * cAngle ;
-                animation.z = 500 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = -10;
-                animation.offset_y = 20 * move.linear[1];
-                animation.offset_x = 10;
-                animation.low_limit = 0;
-                show3 = { Layer3 ? render_value(animation) : 0};
-
-                animation.dist = 
-                    (10 + move.directional[2]) * FL_SIN_F(-move.radial[5] + 
-                    move.radial[2] + (distance[x][y] / (3)));
-                animation.angle = 1 * polar_theta[x][y] * cAngle ;
-                animation.z = 500 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = -10;
-                animation.offset_y = 20 * move.linear[2];
-                animation.offset_x = 10;
-                animation.low_limit = 0;
-                show4 = { Layer4 ? render_value(animation) : 0};
-
-                // float radius = radial_filter_radius;   // radius of a radial
-                // brightness filter float radial =
-                // (radius-distance[x][y])/distance[x][y];
-
-                // pixel.red    = show2;
-
-                pixel.blue = (0.7 * show2 + 0.6 * show3 + 0.5 * show4);
-                pixel.red = pixel.blue - 40;
-                // pixel.red     = radial*show3;
-                //pixel.green     = 0.9*show4;
-
-                pixel = rgb_sanity_check(pixel);
-
-                setPixelColorInternal(x, y, pixel);
-            }
+        layer *l = begin_layers(4);
+
+        l[0].enabled = params.Layer1;
+        l[0].dist_0 = 4 * FL_SIN_F(move.directional[5] * PI) +
+                      4 * FL_COS_F(move.directional[6] * PI);
+        l[0].dist_d = params.Zoom;
+        l[0].angle_theta = params.Angle;
+        l[0].z_0 = 5 * params.Z;
+        l[0].scale_x = 0.06 * params.Scale;
+        l[0].scale_y = 0.06 * params.Scale;
+        l[0].offset_z = -10 * move.linear[0];
+        l[0].offset_y = 10;
+        l[0].offset_x = 10;
+
+        // ripples: (10 + directional) * sin(distance / 3 + radial[n] - radial[5])
+        const bool enabled[3] = {params.Layer2, params.Layer3, params.Layer4};
+        for (int n = 0; n < 3; n++) {
+            layer &ripple = l[n + 1];
+            ripple.enabled = enabled[n];
+            ripple.wave_amp = 10 + move.directional[n];
+            ripple.wave_freq = 1.0f / 3;
+            ripple.wave_phase = move.radial[n] - move.radial[5];
+            ripple.angle_theta = params.Angle;
+            ripple.z_0 = (n == 0 ? 5 : 500) * params.Z;
+            ripple.scale_x = 0.1 * params.Scale;
+            ripple.scale_y = 0.1 * params.Scale;
+            ripple.offset_z = -10;
+            ripple.offset_y = 20 * move.linear[n];
+            ripple.offset_x = 10;
         }
+
+        // blue = 0.7 * show2 + 0.6 * show3 + 0.5 * show4, red = blue - 40
+        static const channel_mix mix = {
+            {{0, 0.7, 0.6, 0.5}, {0, 0, 0, 0}, {0, 0.7, 0.6, 0.5}},
+            {-40, 0, 0},
+            {MIX_PLAIN, MIX_PLAIN, MIX_PLAIN},
+            false, false};
+        render_layers(mix);
     }
 
     //*******************************************************************************
-    
-    void Experiment1() { 
-
-        timings.master_speed = 0.02 * cSpeed;
-
-        timings.ratio[0] = 0.0025 + cRatBase/100 ; 
-        timings.ratio[1] = 0.0027 + cRatBase/100 * 1.2 * cRatDiff;
-        timings.ratio[2] = 0.0031 + cRatBase/100 * 1.4 * cRatDiff;
-        timings.ratio[3] = 0.0033 + cRatBase/100 * 1.6 * cRatDiff; 
-        timings.ratio[4] = 0.0036 + cRatBase/100 * 1.8 * cRatDiff;
-        timings.ratio[5] = 0.0039 + cRatBase/100 * 2 * cRatDiff;
-
-        calculate_oscillators(timings);
 
-        for (int x = 0; x < num_x ; x++) {
-            for (int y = 0; y < num_y ; y++) {
-
-                animation.dist = distance[x][y] * cZoom;
-                animation.angle = 
-                    polar_theta[x][y] * cAngle 
-                    + 5 * move.noise_angle[0];
-                animation.z = 5 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = 50 * move.linear[0];
-                animation.offset_x = 150 * move.directional[0];
-                animation.offset_y = 150 * move.directional[1];
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.angle = 
-                    polar_theta[x][y] * cAngle 
-                    + 4 * move.noise_angle[1];
-                animation.z = 15 * cZ;
-                animation.scale_x = 0.15 * cScale;
-                animation.scale_y = 0.15 * cScale;
-                animation.offset_z = 50 * move.linear[1];
-                animation.offset_x = 150 * move.directional[1];
-                animation.offset_y = 150 * move.directional[2];
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                animation.angle = 
-                    polar_theta[x][y] * cAngle 
-                    + 5 * move.noise_angle[2];
-                animation.z = 25 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = 50 * move.linear[2];
-                animation.offset_x = 150 * move.directional[2];
-                animation.offset_y = 150 * move.directional[3];
-                show3 = { Layer3 ? render_value(animation) : 0};
-
-                animation.angle = 
-                    polar_theta[x][y] * cAngle 
-                    + 5 * move.noise_angle[3];
-                animation.z = 35 * cZ;
-                animation.scale_x = 0.15 * cScale;
-                animation.scale_y = 0.15 * cScale;
-                animation.offset_z = 50 * move.linear[3];
-                animation.offset_x = 150 * move.directional[3];
-                animation.offset_y = 150 * move.directional[4];
-                show4 = { Layer4 ? render_value(animation) : 0};
-
-                animation.angle = 
-                    polar_theta[x][y] * cAngle 
-                    + 5 * move.noise_angle[4];
-                animation.z = 45 * cZ;
-                animation.scale_x = 0.2 * cScale;
-                animation.scale_y = 0.2 * cScale;
-                animation.offset_z = 50 * move.linear[4];
-                animation.offset_x = 150 * move.directional[4];
-                animation.offset_y = 150 * move.directional[5];
-                show5 = { Layer5 ? render_value(animation) : 0};
-
-                //show6 = screen(show1, show2);
-                //show7 = colordodge(show3, show4);
-                //show8 = multiply(show5, show7);
-                
-                pixel.red = (show1 + show2) * cRed;
-                pixel.green = (show3 + show4) * cGreen;
-                pixel.blue = show5 * cBlue;
-
-                //pixel.red = (show4/5 + show6) * cRed;
-                //pixel.green = (show5/5 + show7) * cGreen;
-                //pixel.blue = show8 * cBlue;
-
-                pixel = rgb_sanity_check(pixel);
-                setPixelColorInternal(x, y, pixel);
+    void Experiment1() { 
 
-            }
+        timings.master_speed = 0.02 * params.Speed;
+
+        timings.ratio[0] = 0.0025 + params.RatBase/100 ; 
+        timings.ratio[1] = 0.0027 + params.RatBase/100 * 1.2 * params.RatDiff;
+        timings.ratio[2] = 0.0031 + params.RatBase/100 * 1.4 * params.RatDiff;
+        timings.ratio[3] = 0.0033 + params.RatBase/100 * 1.6 * params.RatDiff; 
+        timings.ratio[4] = 0.0036 + params.RatBase/100 * 1.8 * params.RatDiff;
+        timings.ratio[5] = 0.0039 + params.RatBase/100 * 2 * params.RatDiff;
+
+        calculate_oscillators(timings, 0b11111); // reads noise_angle 0, 1, 2, 3, 4
+
+        layer *l = begin_layers(5);
+        const bool enabled[5] = {params.Layer1, params.Layer2, params.Layer3, params.Layer4, params.Layer5};
+        const float spin[5] = {5, 4, 5, 5, 5};
+        const float scale[5] = {0.1, 0.15, 0.1, 0.15, 0.2};
+        for (int n = 0; n < 5; n++) {
+            l[n].enabled = enabled[n];
+            l[n].dist_d = params.Zoom;
+            l[n].angle_theta = params.Angle;
+            l[n].angle_0 = spin[n] * move.noise_angle[n];
+            l[n].z_0 = (5 + 10 * n) * params.Z;
+            l[n].scale_x = scale[n] * params.Scale;
+            l[n].scale_y = scale[n] * params.Scale;
+            l[n].offset_z = 50 * move.linear[n];
+            l[n].offset_x = 150 * move.directional[n];
+            l[n].offset_y = 150 * move.directional[n + 1];
         }
 
+        //show6 = screen(show1, show2);
+        //show7 = colordodge(show3, show4);
+        //show8 = multiply(show5, show7);
+
+        static const channel_mix mix = {
+            {{1, 1, 0, 0, 0}, {0, 0, 1, 1, 0}, {0, 0, 0, 0, 1}},
+            {0, 0, 0},
+            {MIX_PLAIN, MIX_PLAIN, MIX_PLAIN},
+            true, false};
+        render_layers(mix);
     }
 
     //*******************************************************************************
 
     void Experiment2() {
 
-        timings.master_speed = 0.01 * cSpeed; 
+        timings.master_speed = 0.01 * params.Speed; 
 
-        timings.ratio[0] = 0.01 + cRatBase/10;
-        timings.ratio[1] = 0.011 + cRatBase/10;
-        timings.ratio[2] = 0.013 + cRatBase/10;
-        timings.ratio[3] = 0.33 + cRatBase * cRatDiff;
-        timings.ratio[4] = 0.36 + cRatBase * cRatDiff; 
-        timings.ratio[5] = 0.38 + cRatBase * cRatDiff;
+        timings.ratio[0] = 0.01 + params.RatBase/10;
+        timings.ratio[1] = 0.011 + params.RatBase/10;
+        timings.ratio[2] = 0.013 + params.RatBase/10;
+        timings.ratio[3] = 0.33 + params.RatBase * params.RatDiff;
+        timings.ratio[4] = 0.36 + params.RatBase * params.RatDiff; 
+        timings.ratio[5] = 0.38 + params.RatBase * params.RatDiff;
         timings.ratio[6] = 0.0003; // master rotation
 
         timings.offset[0] = 0;
-        timings.offset[1] = 100 * cOffBase * cOffDiff;
-        timings.offset[2] = 200 * cOffBase * 1.2 * cOffDiff;
-        timings.offset[3] = 300 * cOffBase * 1.4 * cOffDiff;
-        timings.offset[4] = 400 * cOffBase * 1.6 * cOffDiff;
-        timings.offset[5] = 500 * cOffBase * 1.8 * cOffDiff;
-        timings.offset[6] = 600 * cOffBase * 2 * cOffDiff;
-
-        calculate_oscillators(timings);
-
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                float r = 1.5; // scroll speed
-
-                animation.dist =
-                    3 + distance[x][y] * cZoom +
-                    3 * FL_SIN_F(0.25 * distance[x][y] * cZoom
-                    - move.radial[3]);
-                animation.angle = 
-                    polar_theta[x][y] * cAngle
-                    + move.noise_angle[0] 
-                    + move.noise_angle[6];
-                animation.z = 5 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = 10 * move.linear[0];
-                animation.offset_y = -5 * r * move.linear[0];
-                animation.offset_x = 10;
-                animation.low_limit = 0;
-                show1 = { Layer1 ? render_value(animation) : 0};
-
-                animation.dist =
-                    4 + distance[x][y] * cZoom +
-                    4 * FL_SIN_F(0.24 * distance[x][y] * cZoom
-                    - move.radial[4]);
-                animation.angle = 
-                    polar_theta[x][y] * cAngle
-                    + move.noise_angle[1] 
-                    + move.noise_angle[6];
-                animation.z = 5 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = 0.1 * move.linear[1];
-                animation.offset_y = -5 * r * move.linear[1];
-                animation.offset_x = 100;
-                animation.low_limit = 0;
-                show2 = { Layer2 ? render_value(animation) : 0};
-
-                animation.dist =
-                    5 + distance[x][y]
-                    + 5 * FL_SIN_F(0.23 * distance[x][y] 
-                    - move.radial[5]);
-                animation.angle = 
-                    polar_theta[x][y] * cAngle 
-                    + move.noise_angle[2] 
-                    + move.noise_angle[6];
-                animation.z = 5 * cZ;
-                animation.scale_x = 0.1 * cScale;
-                animation.scale_y = 0.1 * cScale;
-                animation.offset_z = 0.1 * move.linear[2];
-                animation.offset_y = -5 * r * move.linear[2];
-                animation.offset_x = 1000;
-                animation.low_limit = 0;
-                show3 = { Layer3 ? render_value(animation) : 0};
-
-                show4 = colordodge(show1, show2);
-
-                //float rad = FL_SIN_F(PI / 2 + distance[x][y] / 14); // better radial filter?!
-
-                float radius = radial_filter_radius * cRadius;
-                radialFilterFalloff = cEdge;
-                radialDimmer = radialFilterFactor(radius, distance[x][y], radialFilterFalloff);
-
-
-                /*
-                pixel.red    = show1;
-                pixel.green  = show1 * 0.3;
-                pixel.blue   = show2-show1;
-                */
-
-                CHSV(radialDimmer * ((show1 + show2) + show3), 255, 255);
-
-                pixel = rgb_sanity_check(pixel);
-
-                uint8_t a = getTime() / 100;
-                CRGB p = CRGB(CHSV(((a + show1 + show2) + show3), 255, 255));
-                rgb pixel;
-                pixel.red = p.red * cRed;
-                pixel.green = p.green * cGreen;
-                pixel.blue = p.blue * cBlue;
-                setPixelColorInternal(x, y, pixel);
-            }
+        timings.offset[1] = 100 * params.OffBase * params.OffDiff;
+        timings.offset[2] = 200 * params.OffBase * 1.2 * params.OffDiff;
+        timings.offset[3] = 300 * params.OffBase * 1.4 * params.OffDiff;
+        timings.offset[4] = 400 * params.OffBase * 1.6 * params.OffDiff;
+        timings.offset[5] = 500 * params.OffBase * 1.8 * params.OffDiff;
+        timings.offset[6] = 600 * params.OffBase * 2 * params.OffDiff;
+
+        calculate_oscillators(timings, 0b1000111); // reads noise_angle 0, 1, 2, 6
+
+        float r = 1.5; // scroll speed
+
+        layer *l = begin_layers(3);
+        const bool enabled[3] = {params.Layer1, params.Layer2, params.Layer3};
+        // dist = k + distance + k * sin(freq * distance - radial[3 + n]);
+        // layers 1 and 2 follow params.Zoom, layer 3 doesn't
+        const float zoom[3] = {params.Zoom, params.Zoom, 1};
+        const float freq[3] = {0.25, 0.24, 0.23};
+        const float offset_z[3] = {10, 0.1, 0.1};
+        const float offset_x[3] = {10, 100, 1000};
+        for (int n = 0; n < 3; n++) {
+            l[n].enabled = enabled[n];
+            l[n].dist_0 = 3 + n;
+            l[n].dist_d = zoom[n];
+            l[n].wave_amp = 3 + n;
+            l[n].wave_freq = freq[n] * zoom[n];
+            l[n].wave_phase = -move.radial[3 + n];
+            l[n].angle_theta = params.Angle;
+            l[n].angle_0 = move.noise_angle[n] + move.noise_angle[6];
+            l[n].z_0 = 5 * params.Z;
+            l[n].scale_x = 0.1 * params.Scale;
+            l[n].scale_y = 0.1 * params.Scale;
+            l[n].offset_z = offset_z[n] * move.linear[n];
+            l[n].offset_y = -5 * r * move.linear[n];
+            l[n].offset_x = offset_x[n];
         }
+
+        // hue = time / 100 + show1 + show2 + show3
+        static const channel_mix mix = {
+            {{0}, {0}, {0}},
+            {0, 0, 0},
+            {MIX_PLAIN, MIX_PLAIN, MIX_PLAIN},
+            true, true};
+        render_layers(mix);
     }
 
     //*******************************************************************************
@@ -1167,33 +1651,22 @@ class ANIMartRIX {
         //timings.master_speed = 0.003;
         calculate_oscillators(timings);
 
-        for (int x = 0; x < num_x; x++) {
-            for (int y = 0; y < num_y; y++) {
-
-                animation.dist = (distance[x][y] * distance[x][y]) * cZoom / 2;
-                animation.angle = polar_theta[x][y] * cAngle;
-
-                animation.scale_x = 0.005 * cScale * cSpeedInt;
-                animation.scale_y = 0.005 * cScale;
-
-                animation.offset_y = -10 * move.linear[0];
-                animation.offset_x = cSpeedInt;
-                animation.offset_z = 0.1 * move.linear[0];
-
-                animation.z = 0;
-                animation.low_limit = 0;
-                float show1 = render_value(animation);
-
-                // float linear = 1;//(y+1)/(num_y-1.f);
-
-                pixel.red = show1;
-                pixel.green = 0;
-                pixel.blue = 40 - show1;
-
-                pixel = rgb_sanity_check(pixel);
-                setPixelColorInternal(x, y, pixel);
-            }
-        }
+        layer *l = begin_layers(1);
+        l[0].enabled = true;
+        l[0].dist_d2 = params.Zoom / 2;
+        l[0].angle_theta = params.Angle;
+        l[0].scale_x = 0.005 * params.Scale * params.SpeedInt;
+        l[0].scale_y = 0.005 * params.Scale;
+        l[0].offset_y = -10 * move.linear[0];
+        l[0].offset_x = params.SpeedInt;
+        l[0].offset_z = 0.1 * move.linear[0];
+
+        static const channel_mix mix = {
+            {{1}, {0}, {-1}},
+            {0, 0, 40},
+            {MIX_PLAIN, MIX_PLAIN, MIX_PLAIN},
+            false, false};
+        render_layers(mix);
     }
 
 //*******************************************************************************
@@ -16,17 +16,20 @@ namespace blur {
         // Store XYMap references
 		myXYmapPtr = &myXYmapRef;
 		xyRectPtr = &xyRectRef;
-
-        uint8_t pos = 0;
-        bool toggle = false;
 	}
 
-	void runBlur() {
+	void runBlur(uint32_t now) {
         static int x = random(WIDTH);
         static int y = random(HEIGHT);
         static CRGB c = CRGB(0, 0, 0);
+        static uint32_t lastNow = now;
+        static uint32_t seedTime = now;
+        // each pass blurs the frame further, so a paused clock skips it
+        if (now == lastNow) return;
+        lastNow = now;
         blur2d(leds, WIDTH, HEIGHT, BLUR_AMOUNT, *myXYmapPtr);
-        EVERY_N_MILLISECONDS(1000) {
+        if (now - seedTime >= 1000) {
+            seedTime = now;
             x = random(WIDTH);
             y = random(HEIGHT);
             uint8_t r = random(255);
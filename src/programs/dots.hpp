@@ -5,6 +5,6 @@
 namespace dots {
     extern bool dotsInstance;
     
-    void initDots(uint16_t (*xy_func)(uint8_t, uint8_t));
-    void runDots();
+    void initDots();
+    void runDots(const FrameParams& params);
 }
\ No newline at end of file
@@ -6,12 +6,8 @@ namespace dots {
 
 	bool dotsInstance = false;
 
-	// Function pointer to access XY function from main.cpp
-	uint16_t (*xyFunc)(uint8_t x, uint8_t y);
-
-	void initDots(uint16_t (*xy_func)(uint8_t, uint8_t)) {
+	void initDots() {
 		dotsInstance = true;
-		xyFunc = xy_func;  
 	}
 
 	float osci[4]; 
@@ -19,19 +15,19 @@ namespace dots {
 	float pY[4];
 
 	void PixelA(uint8_t x, uint8_t y, byte color) {
-		leds[xyFunc(x, y)] = CHSV(color, 255, 255);
+		leds[rasterXY(x, y)] = CHSV(color, 255, 255);
 	}
 
 	void PixelB(uint8_t x, uint8_t y, byte color) {
-		leds[xyFunc(x, y)] = CHSV(color, 255, 255);
+		leds[rasterXY(x, y)] = CHSV(color, 255, 255);
 	}
 
 	// set the speeds (and by that ratios) of the oscillators
-	void MoveOscillators() {
-		osci[0] = osci[0] + 0.6f * cSpeed; 
-		osci[1] = osci[1] + 0.1f * cSpeed; 
-		osci[2] = osci[2] + 0.3f * cSpeed; 
-		osci[3] = osci[3] + 0.4f * cSpeed; 
+	void MoveOscillators(float speed) {
+		osci[0] = osci[0] + 0.6f * speed; 
+		osci[1] = osci[1] + 0.1f * speed; 
+		osci[2] = osci[2] + 0.3f * speed; 
+		osci[3] = osci[3] + 0.4f * speed; 
 		for(int i = 0; i < 4; i++) { 
 			//pX[i] = map(sin8((byte)osci[i]),0,255,0,WIDTH-1);
 			//pY[i] = map(sin8((byte)osci[i]),0,255,0,HEIGHT-1);
@@ -45,17 +41,23 @@ namespace dots {
 	{
 		for(uint8_t x = 0; x < WIDTH ; x++) {
 			for(uint8_t y = 1; y < HEIGHT; y++) { 
-				leds[xyFunc(x,y)] += leds[xyFunc(x,y-1)];
-				leds[xyFunc(x,y)].nscale8(scale);
+				leds[rasterXY(x,y)] += leds[rasterXY(x,y-1)];
+				leds[rasterXY(x,y)].nscale8(scale);
 			}
 		}
 		for(uint8_t x = 0; x < WIDTH; x++) 
-			leds[xyFunc(x,0)].nscale8(scale);
+			leds[rasterXY(x,0)].nscale8(scale);
 	}
 
-	void runDots() {
+	// The oscillator steps were tuned per frame at about 60 fps; they now scale
+	// with the frame's animation time, and a paused clock holds the whole frame.
+	#define DOTS_FRAME_MS 16.0f
+
+	void runDots(uint32_t delta, const FrameParams& params) {
+
+		if (delta == 0) return;
 
-		MoveOscillators();
+		MoveOscillators(params.Speed * delta / DOTS_FRAME_MS);
 
 		PixelA( 
 			(pX[2]+pX[0]+pX[1])/3,
@@ -69,7 +71,7 @@ namespace dots {
 			osci[3]
 		);
 		
-		VerticalStream(60 * cTail);
+		VerticalStream(60 * params.Tail);
 		//HorizontalStream(75);
 		//FastLED.delay(5);
 	}
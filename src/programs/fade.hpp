@@ -6,6 +6,6 @@ namespace fade {
     extern bool fadeInstance;
     
     void initFade();
-    void runFade();
+    void runFade(uint32_t now);
 
 } // namespace fade
\ No newline at end of file
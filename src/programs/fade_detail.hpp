@@ -8,46 +8,43 @@ namespace fade {
 
 	void initFade() {
 		fadeInstance = true;
-		CRGB leds[NUM_LEDS];
-		CRGB leds2[NUM_LEDS];
-		CRGB leds3[NUM_LEDS];
 	}
 
-	void animationA() {
+	void animationA(uint32_t now) {
 	// running red stripes 
+	uint8_t start = now / 3;
 	for (uint16_t i = 0; i < NUM_LEDS; i++) {
-		uint8_t red = (millis() / 3) + (i * 5);
+		uint8_t red = start + (i * 5);
 		if (red > 128) red = 0;
 		leds2[i] = CRGB(red, 0, 0);
 	}
 	}
 
-	void animationB() {
+	void animationB(uint32_t now) {
 	// the moving rainbow
+	uint8_t start = now / 4;
 	for (uint16_t i = 0; i < NUM_LEDS; i++) {
-		leds3[i] = CHSV((millis() / 4) - (i * 3), 255, 255);
+		leds3[i] = CHSV(start - (i * 3), 255, 255);
 	}
 	}
 
-	void runFade() {
+	void runFade(uint32_t now) {
 	
 		// render the first animation into leds2 
-		animationA();
+		animationA(now);
 
 		// render the second animation into leds3
-		animationB();
+		animationB(now);
 
 		// set the blend ratio for the video cross fade
 		// (set ratio to 127 for a constant 50% / 50% blend)
-		uint8_t ratio = beatsin8(5);
+		uint8_t ratio = beatsin8At(now, 5);
 
 		// mix the 2 arrays together
 		for (int i = 0; i < NUM_LEDS; i++) {
 		leds[i] = blend( leds2[i], leds3[i], ratio );
 		}
 
-		FastLED.show();
-
 	} // runFade()
 
 } // namespace fade
@@ -5,7 +5,7 @@
 namespace fire {
     extern bool fireInstance;
     
-    void initFire(uint16_t (*xy_func)(uint8_t, uint8_t));
-    void runFire();
+    void initFire();
+    void runFire(uint32_t now, const FrameParams& params);
 
 } // namespace fire
\ No newline at end of file
@@ -1,17 +1,22 @@
 #pragma once
 
 #include "bleControl.h"
+#include "keyframes.h"
 #include "fx/time.h"  
 
 namespace fire {
 
 	bool fireInstance = false;
-	uint16_t (*xyFunc)(uint8_t x, uint8_t y);
 
-	void initFire(uint16_t (*xy_func)(uint8_t, uint8_t)) {
-		fireInstance = true;
-		xyFunc = xy_func;
-	}
+	KeyframeBlender<NUM_LEDS> fireKeys;
+
+	// Fire2023() is a simulation stepped every FIRE_STEP_MS: each step moves the
+	// heat a row up, so the step rate is the flame speed. With keyframes on, a
+	// keyframe runs all the steps due since the previous one, at their own
+	// timestamps, and the blender only smooths what is shown in between.
+	#define FIRE_STEP_MS 8
+	#define FIRE_MAX_CATCHUP (1000 / FIRE_STEP_MS)   // steps; more than this restarts the clock
+	uint32_t fireStepTime = 0;   // timestamp of the last simulated step
 
 	DEFINE_GRADIENT_PALETTE(hot_gp) {
 		27, 0, 0, 0,                     // black
@@ -55,10 +60,90 @@ namespace fire {
 	uint8_t noise[NUM_LAYERS][WIDTH][HEIGHT];
 	uint8_t noise2[NUM_LAYERS][WIDTH][HEIGHT];
 
-	uint16_t heat[NUM_LEDS];
+	// heat map in the same raster order as leds[], as heat[y][x]
+	uint8_t heat[HEIGHT][WIDTH];
+
+	// Scrolling noise field ************************************************
+	// Both noise layers mostly scroll along y, so rather than sampling every
+	// cell each tick, rows are sampled on a fixed lattice (one row per scale_y
+	// of noise space) and kept in a ring buffer. A tick evaluates the lattice
+	// rows that scrolled into view plus a round-robin share of the others, so
+	// the slow x drift and z evolution reach every row within
+	// NOISE_REFRESH_TICKS ticks. A cell is the 16-bit lerp of the two lattice
+	// rows around it.
+
+	#define NOISE_ROWS (HEIGHT + 1)
+	#define NOISE_REFRESH_TICKS 4
+
+	struct NoiseField {
+
+		// inoise16() + 1 at cell (col, row) of the field last passed to update()
+		uint16_t cell(uint8_t col, uint8_t row) const {
+			const uint16_t a = rows[(firstRow + row) % NOISE_ROWS][col];
+			const uint16_t b = rows[(firstRow + row + 1) % NOISE_ROWS][col];
+			return a + (int32_t)(((int64_t)(b - a) * frac) >> 16) + 1;
+		}
+
+		// Cell (col, row) samples inoise16(xOrigin + scaleX * (col - CentreX),
+		// yOrigin + scaleY * (row - CentreY), zOrigin).
+		void update(uint32_t xOrigin, uint32_t yOrigin, uint32_t zOrigin, uint32_t scaleX, uint32_t scaleY) {
+			xo = xOrigin;
+			zo = zOrigin;
+			sx = scaleX;
+			if (scaleY != sy) primed = false;
+			sy = scaleY;
+
+			// row 0 sits between lattice rows base / sy and base / sy + 1
+			const uint32_t base = yOrigin + sy * (0 - CentreY);
+			const uint32_t k0 = base / sy;
+			frac = (base % sy) * 65536 / sy;
+
+			if (!primed || k0 < firstRow || k0 - firstRow >= NOISE_ROWS) {
+				for (uint32_t k = k0; k < k0 + NOISE_ROWS; k++) sampleRow(k);
+				firstRow = k0;
+				primed = true;
+				return;
+			}
+			for (uint32_t k = firstRow + NOISE_ROWS; k < k0 + NOISE_ROWS; k++) sampleRow(k);
+			firstRow = k0;
+
+			for (uint8_t r = 0; r < (NOISE_ROWS + NOISE_REFRESH_TICKS - 1) / NOISE_REFRESH_TICKS; r++) {
+				refreshCursor = (refreshCursor + 1) % NOISE_ROWS;
+				sampleRow(firstRow + refreshCursor);
+			}
+		}
+
+		void reset() { primed = false; }
+
+	  private:
+
+		uint16_t rows[NOISE_ROWS][WIDTH];   // lattice row k lives in rows[k % NOISE_ROWS]
+		uint32_t firstRow = 0;              // lattice row under cell row 0
+		uint32_t xo = 0, zo = 0, sx = 0, sy = 0;
+		uint32_t frac = 0;                  // position between the two lattice rows, 0-65535
+		uint8_t refreshCursor = 0;
+		bool primed = false;
+
+		void sampleRow(uint32_t k) {
+			uint16_t* row = rows[k % NOISE_ROWS];
+			for (uint8_t col = 0; col < WIDTH; col++) {
+				row[col] = inoise16(xo + sx * (col - CentreX), k * sy, zo);
+			}
+		}
+	};
+
+	NoiseField noiseField[NUM_LAYERS];
 
 	void Fire2023(uint32_t now);
 
+	void initFire() {
+		fireInstance = true;
+		fireKeys.reset();
+		fireStepTime = 0;
+		noiseField[FIRENOISE].reset();
+		noiseField[SMOKENOISE].reset();
+	}
+
 
 	/*
 	DEFINE_GRADIENT_PALETTE(firepal){
@@ -195,11 +280,10 @@ void Fire2023(uint32_t now) {
 
 
 		//calculate the perlin noise data for the fire
+		noiseField[FIRENOISE].update(x[FIRENOISE], y[FIRENOISE], z[FIRENOISE], scale_x[FIRENOISE], scale_y[FIRENOISE]);
 		for (uint8_t x_count = 0; x_count < WIDTH; x_count++) {
-			uint32_t xoffset = scale_x[FIRENOISE] * (x_count - CentreX);
 			for (uint8_t y_count = 0; y_count < HEIGHT; y_count++) {
-				uint32_t yoffset = scale_y[FIRENOISE] * (y_count - CentreY);
-				uint16_t data = ((inoise16(x[FIRENOISE] + xoffset, y[FIRENOISE] + yoffset, z[FIRENOISE])) + 1);
+				uint16_t data = noiseField[FIRENOISE].cell(x_count, y_count);
 				noise[FIRENOISE][x_count][y_count] = data >> 8;
 			}
 		}
@@ -221,32 +305,27 @@ void Fire2023(uint32_t now) {
 		scale_y[SMOKENOISE] = SMOKENOISESCALE;
 
 		//calculate the perlin noise data for the smoke
+		noiseField[SMOKENOISE].update(x[SMOKENOISE], y[SMOKENOISE], z[SMOKENOISE], scale_x[SMOKENOISE], scale_y[SMOKENOISE]);
 		for (uint8_t x_count = 0; x_count < WIDTH; x_count++) {
-			uint32_t xoffset = scale_x[SMOKENOISE] * (x_count - CentreX);
 			for (uint8_t y_count = 0; y_count < HEIGHT; y_count++) {
-			uint32_t yoffset = scale_y[SMOKENOISE] * (y_count - CentreY);
-			uint16_t data = ((inoise16(x[SMOKENOISE] + xoffset, y[SMOKENOISE] + yoffset, z[SMOKENOISE])) + 1);
+			uint16_t data = noiseField[SMOKENOISE].cell(x_count, y_count);
 			noise[SMOKENOISE][x_count][y_count] = data / SMOKENOISE_DIMMER;
 			}
 		}
 
 		//copy everything one line up
-		for (uint8_t y = 0; y < HEIGHT - 1; y++) {
-			for (uint8_t x = 0; x < WIDTH; x++) {
-			heat[xyFunc(x, y)] = heat[xyFunc(x, y + 1)];
-			}
-		}
+		memmove(heat[0], heat[1], sizeof(heat[0]) * (HEIGHT - 1));
 
 		// draw lowest line - seed the fire where it is brightest and hottest
 		/*
 		for (uint8_t x = 0; x < WIDTH; x++) {
-			heat[xyFunc(x, HEIGHT-1)] = noise[FIRENOISE][x][x] + (sin8(x * 42) >> 2); // CentreX
+			heat[HEIGHT-1][x] = noise[FIRENOISE][x][x] + (sin8(x * 42) >> 2); // CentreX
 			//if (heat[XY(x, HEIGHT-1)] < 200) heat[XY(x, HEIGHT-1)] = 150; 
 		}
 		*/
   		for (uint8_t x = 0; x < WIDTH; x++) {
       		uint8_t base_heat = noise[FIRENOISE][x][x] + (sin8(x * 42) >> 2) + 50;
-      		heat[xyFunc(x, HEIGHT-1)] = MAX(base_heat, 80);  // Ensure minimum heat of 80
+      		heat[HEIGHT-1][x] = MAX(base_heat, 80);  // Ensure minimum heat of 80
   		}
 
 
@@ -260,17 +339,18 @@ void Fire2023(uint32_t now) {
 			// high value in FLAMEHEIGHT = less dimming = high flames
 			dim = dim / FLAMEHEIGHT;
 			dim = 255 - dim;
-			heat[xyFunc(x, y)] = scale8(heat[xyFunc(x, y)] , dim);
+			heat[y][x] = scale8(heat[y][x], dim);
 
 			// map the colors based on heatmap
 			// use the heat map to set the color of the LED from the "hot" palette
 			//                               whichpalette    position      brightness     blend or not
-			leds[xyFunc(x, y)] = ColorFromPalette(hotPalette, heat[xyFunc(x, y)], heat[xyFunc(x, y)], LINEARBLEND);
+			CRGB& led = leds[rasterXY(x, y)];
+			led = ColorFromPalette(hotPalette, heat[y][x], heat[y][x], LINEARBLEND);
 
 			// dim the result based on SMOKENOISE noise
 			// this is not saved in the heat map - the flame may dim away and come back
 			// next iteration.
-			leds[xyFunc(x, y)].nscale8(noise[SMOKENOISE][x][y]);
+			led.nscale8(noise[SMOKENOISE][x][y]);
 
 			}
 		}
@@ -279,7 +359,7 @@ void Fire2023(uint32_t now) {
 
 	//******************************************************
 
-	void runFire() {
+	void runFire(uint32_t now, const FrameParams& params) {
 	
 		/*
 		// Get the selected color palette
@@ -309,7 +389,7 @@ void Fire2023(uint32_t now) {
 				// Convert our 2D coordinates to the 1D array index
 				// We use (WIDTH-1)-width and (HEIGHT-1)-height to flip the coordinates
 				// This makes the fire appear to rise from the bottom
-				int index = xyFunc((WIDTH - 1) - width, (HEIGHT - 1) - height);
+				int index = rasterXY((WIDTH - 1) - width, (HEIGHT - 1) - height);
 				
 				// Set the LED color in our array
 				leds[index] = c;
@@ -317,11 +397,30 @@ void Fire2023(uint32_t now) {
 		}
 		*/
 
-		EVERY_N_MILLISECONDS(8) {
-			Fire2023(millis());
+		// the user's rate only: keyframes save no simulation steps, so the
+		// governor gains nothing by forcing them here
+		fireKeys.setRate(params.KeyRate);
+		if (fireKeys.rate() == 0) {
+			// at most one step a frame, as before, but on animation time so
+			// a pause holds the flames
+			if (now - fireStepTime >= FIRE_STEP_MS) {
+				fireStepTime = now;
+				Fire2023(now);
+			}
+		} else if (fireKeys.due(now)) {
+			uint32_t steps = (now - fireStepTime) / FIRE_STEP_MS;
+			if (steps > FIRE_MAX_CATCHUP) {
+				// first keyframe, or back after a pause: start from here
+				steps = 1;
+				fireStepTime = now - FIRE_STEP_MS;
+			}
+			for (; steps > 0; steps--) {
+				fireStepTime += FIRE_STEP_MS;
+				Fire2023(fireStepTime);
+			}
+			fireKeys.push(leds, now);
 		}
-
-		FastLED.show();
+		fireKeys.blend(leds, now);
 
 	} // runfire()
 
@@ -7,8 +7,8 @@
 namespace rainbow {
     extern bool rainbowInstance;
     
-    void initRainbow(uint16_t (*xy_func)(uint8_t, uint8_t));
-    void runRainbow();
+    void initRainbow();
+    void runRainbow(uint32_t now);
 
     //FASTLED_SMART_PTR(Rainbow);
 
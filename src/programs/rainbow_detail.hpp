@@ -6,11 +6,8 @@ namespace rainbow {
 
 	bool rainbowInstance = false;
 
-	uint16_t (*xyFunc)(uint8_t x, uint8_t y);
-
-	void initRainbow(uint16_t (*xy_func)(uint8_t, uint8_t)) {
+	void initRainbow() {
 		rainbowInstance = true;
-		xyFunc = xy_func;
 	}
 
 	//Rainbow rainbow(NUM_LEDS);
@@ -22,15 +19,14 @@ namespace rainbow {
 			uint8_t pixelHue = lineStartHue;      
 			for( uint8_t x = 0; x < WIDTH; x++) {
 				pixelHue += xHueDelta8;
-				ledNum = xyFunc(x,y);
-				leds[ledNum] = CHSV(pixelHue, 255, 175);
+				leds[rasterXY(x,y)] = CHSV(pixelHue, 255, 175);
 				//rainbow.draw(Fx::DrawContext(millis(), leds));
 			}  
 		}
 	}
 
-	void runRainbow() {
-		uint32_t ms = millis();
+	void runRainbow(uint32_t now) {
+		uint32_t ms = now;
 		float oscRateY = ms * 27 ;
 		float oscRateX = ms * 39 ;
 		int32_t yHueDelta32 = ((int32_t)cos16( oscRateY ) * 10 );
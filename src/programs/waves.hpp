@@ -6,6 +6,6 @@ namespace waves {
     extern bool wavesInstance;
     
     void initWaves();
-    void runWaves();
+    void runWaves(uint32_t now, const FrameParams& params);
 
 } // namespace waves
\ No newline at end of file
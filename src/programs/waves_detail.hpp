@@ -16,10 +16,15 @@ namespace waves {
 		startingPalette();
 	}
 
-	void runWaves() {
+	void runWaves(uint32_t now, const FrameParams& params) {
 
-		if (MODE==0 && rotateWaves) {
-			EVERY_N_SECONDS( SECONDS_PER_PALETTE ) {
+		// on animation time, like everything below, so a pause holds the palette too
+		static uint32_t paletteTime = now;
+		static uint32_t paletteBlendTime = now;
+
+		if (MODE==0 && params.rotateWaves) {
+			if (now - paletteTime >= SECONDS_PER_PALETTE * 1000) {
+				paletteTime = now;
 				//capture the prior target palNum as the current palNum 
 				gCurrentPaletteNumber = gTargetPaletteNumber; 
 				//then set a new target
@@ -31,7 +36,8 @@ namespace waves {
 				}
 			}
 		
-			EVERY_N_MILLISECONDS(40) {
+			if (now - paletteBlendTime >= 40) {
+				paletteBlendTime = now;
 				if (gCurrentPalette != gTargetPalette) {
 					nblendPaletteTowardPalette( gCurrentPalette, gTargetPalette, 16); 
 				}
@@ -51,18 +57,18 @@ namespace waves {
 		static uint16_t sLastMillis = 0;
 		static uint16_t sHue16 = 0;
 	
-		uint8_t sat8 = beatsin88( 87, 230, 255); 
-		uint8_t brightdepth = beatsin88( 341, 96, 250); // beatsin88( 341, 96, 224)
-		uint16_t brightnessthetainc16 = beatsin88( 203*cBrightTheta, (25 * 256), (40 * 256));
-		uint8_t msmultiplier = beatsin88(147, 15, 45); // beatsin88(147, 23, 60)
+		uint8_t sat8 = beatsin88At(now, 87, 230, 255); 
+		uint8_t brightdepth = beatsin88At(now, 341, 96, 250); // beatsin88( 341, 96, 224)
+		uint16_t brightnessthetainc16 = beatsin88At(now, 203*params.BrightTheta, (25 * 256), (40 * 256));
+		uint8_t msmultiplier = beatsin88At(now, 147, 15, 45); // beatsin88(147, 23, 60)
 	
 		uint16_t hue16 = sHue16; 
-		uint16_t hueinc16 = beatsin88(113, 1, cHueIncMax);
-		uint16_t ms = millis();  
+		uint16_t hueinc16 = beatsin88At(now, 113, 1, params.HueIncMax);
+		uint16_t ms = now;  
 		uint16_t deltams = ms - sLastMillis ;
 		sLastMillis  = ms;     
-		sPseudotime += deltams * msmultiplier*cSpeed;
-		sHue16 += deltams * beatsin88( 400, 5,9);  
+		sPseudotime += deltams * msmultiplier*params.Speed;
+		sHue16 += deltams * beatsin88At(now, 400, 5,9);  
 		uint16_t brightnesstheta16 = sPseudotime;
 
 		for( uint16_t i = 0 ; i < NUM_LEDS; i++ ) {
@@ -103,19 +109,10 @@ namespace waves {
 				}
 			}
 
-			switch(cMapping) {
-				case 0:	 ledNum = progTopDown[i]; break;
-				case 1:	 ledNum = progBottomUp[i]; break;
-				case 2:	 ledNum = serpTopDown[i]; break;
-				case 3:	 ledNum = serpBottomUp[i]; break;
-				case 4:	 ledNum = vProgTopDown[i]; break;
-				case 5:	 ledNum = vSerpTopDown[i]; break;
-			}
-
 			//EaseType ease_sat = getEaseType(cEaseSat);
        		//EaseType ease_lum = getEaseType(cEaseLum);
 
-			nblend( leds[ledNum], newcolor, cBlendFract); // .colorBoost(ease_sat, ease_lum);
+			nblend( leds[i], newcolor, params.BlendFract); // .colorBoost(ease_sat, ease_lum);
 
 		}
 	//FastLED.delay(5);	
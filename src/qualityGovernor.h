@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+
+// Quality governor *************************************************************
+// loop() reports how long each frame's render and hand-off took. A window of
+// frames averaging over the budget costs one quality level, and windows
+// comfortably under it win levels back. The levels are cumulative:
+//
+//   QUALITY_FEWER_LAYERS  Animartrix skips layers past GOVERNOR_MAX_LAYERS,
+//                         enabled or not (disabled Layer1..Layer5 are never
+//                         rendered at any level, so skipping only those
+//                         would save nothing)
+//   QUALITY_FAST_NOISE    Animartrix samples noise with pnoise_q16()
+//   QUALITY_KEYFRAMES     Animartrix interpolates between keyframes (not fire:
+//                         its simulation steps every 8 ms regardless, so
+//                         keyframes would only add latency)
+//   QUALITY_HALF_RES      Animartrix renders every other column
+//
+// Restoring needs GOVERNOR_RESTORE_WINDOWS calm windows in a row, and twice as
+// many each time a restored level immediately runs over again, so a load that
+// sits right at the edge of a level doesn't toggle it every window.
+
+enum QualityLevel : uint8_t {
+	QUALITY_FULL = 0,
+	QUALITY_FEWER_LAYERS,
+	QUALITY_FAST_NOISE,
+	QUALITY_KEYFRAMES,
+	QUALITY_HALF_RES,
+	QUALITY_LEVELS
+};
+
+#define GOVERNOR_WINDOW 16            // frames per decision
+#define GOVERNOR_HEADROOM_PCT 70      // a window below this % of the budget is calm
+#define GOVERNOR_RESTORE_WINDOWS 4
+#define GOVERNOR_MAX_RESTORE_WINDOWS 64
+#define GOVERNOR_MAX_LAYERS 3         // at QUALITY_FEWER_LAYERS
+#define GOVERNOR_KEY_RATE 30          // keyframes per second at QUALITY_KEYFRAMES
+
+class QualityGovernor {
+
+  public:
+
+	// Target render + hand-off time per frame; 0 switches the governor off.
+	void setBudget(uint8_t ms) {
+		if (ms == budgetMs) return;
+		budgetMs = ms;
+		if (budgetMs == 0) current = QUALITY_FULL;
+		restartWindow();
+	}
+
+	uint8_t budget() const { return budgetMs; }
+	uint8_t level() const { return current; }
+
+	void frame(uint32_t workUs) {
+		if (budgetMs == 0) return;
+		sumUs += workUs;
+		if (++frames < GOVERNOR_WINDOW) return;
+
+		const uint32_t averageUs = sumUs / frames;
+		const uint32_t budgetUs = budgetMs * 1000;
+		restartWindow();
+
+		if (averageUs > budgetUs) {
+			// the level we just restored still doesn't fit: wait longer next time
+			if (justRestored) restoreAfter = std::min(restoreAfter * 2, GOVERNOR_MAX_RESTORE_WINDOWS);
+			justRestored = false;
+			calm = 0;
+			if (current < QUALITY_LEVELS - 1) current++;
+			return;
+		}
+		if (justRestored) restoreAfter = GOVERNOR_RESTORE_WINDOWS;
+		justRestored = false;
+
+		if (averageUs * 100 >= budgetUs * GOVERNOR_HEADROOM_PCT) {
+			calm = 0;
+			return;
+		}
+		if (++calm >= restoreAfter && current > QUALITY_FULL) {
+			current--;
+			calm = 0;
+			justRestored = true;
+		}
+	}
+
+	// What each level means for the renderers
+
+	uint8_t maxLayers(uint8_t all) const {
+		return current >= QUALITY_FEWER_LAYERS ? std::min<uint8_t>(all, GOVERNOR_MAX_LAYERS) : all;
+	}
+
+	bool fastNoise() const { return current >= QUALITY_FAST_NOISE; }
+
+	// The user's keyframe rate, capped (or switched on) while degraded.
+	uint8_t keyRate(uint8_t requested) const {
+		if (current < QUALITY_KEYFRAMES) return requested;
+		return requested == 0 ? GOVERNOR_KEY_RATE : std::min<uint8_t>(requested, GOVERNOR_KEY_RATE);
+	}
+
+	uint8_t columnStride() const { return current >= QUALITY_HALF_RES ? 2 : 1; }
+
+  private:
+
+	uint8_t budgetMs = 0;
+	uint8_t current = QUALITY_FULL;
+	uint32_t sumUs = 0;
+	uint16_t frames = 0;
+	uint16_t calm = 0;                  // calm windows in a row
+	uint16_t restoreAfter = GOVERNOR_RESTORE_WINDOWS;
+	bool justRestored = false;
+
+	void restartWindow() {
+		sumUs = 0;
+		frames = 0;
+	}
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <atomic>
+
+#ifdef AURORA_SIM
+#include "simHost.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+// Render / output pipeline *****************************************************
+// loop() renders frame N+1 into leds[] while a separate output task pushes
+// frame N down the wire with FastLED.show(), so rendering and WS2812
+// transmission overlap instead of adding up.
+//
+// Finished frames move between the two sides through three slots: the
+// renderer fills `back`, the output task shows `front`, and `middle` holds
+// the newest finished frame. publish() and acquire() each swap their slot
+// with `middle` in one atomic exchange, so neither side ever waits for the
+// other. If the renderer gets ahead, the output task skips to the newest
+// frame and the older one is counted as skipped.
+//
+// On the ESP32-S3 loop() stays on core 1 and the output task is pinned to
+// core 0 next to the BLE stack. The host build runs the output side inline by
+// default so runs stay reproducible; sim::setThreadedOutput(true) moves it to
+// a std::thread instead.
+
+#define OUTPUT_TASK_CORE 0
+#define OUTPUT_TASK_PRIORITY 2
+#define OUTPUT_TASK_STACK 4096
+
+template <uint16_t N>
+class RenderPipeline {
+
+  public:
+
+	CRGB shown[N];   // the LED controller is registered on this buffer
+
+	~RenderPipeline() { end(); }
+
+	// Call once after FastLED.addLeds(); FastLED.show() belongs to the output side from here on.
+	void begin() {
+		#ifdef AURORA_SIM
+		if (sim::threadedOutput() && !worker.joinable()) {
+			stopping = false;
+			worker = std::thread([this] { outputLoop(); });
+		}
+		#else
+		if (!task) {
+			xTaskCreatePinnedToCore(outputTask, "ledOutput", OUTPUT_TASK_STACK, this,
+									OUTPUT_TASK_PRIORITY, &task, OUTPUT_TASK_CORE);
+		}
+		#endif
+	}
+
+	// Hands a finished frame (and the brightness it was rendered for) to the output side.
+	// With a source table the copy is the output remap: LED i shows frame[source[i]].
+	void publish(const CRGB* frame, const uint16_t* source = nullptr) {
+		if (source) {
+			CRGB* out = slots[back];
+			for (uint16_t i = 0; i < N; i++) out[i] = frame[source[i]];
+		} else {
+			memcpy(slots[back], frame, sizeof(slots[back]));
+		}
+		brightness[back] = FastLED.getBrightness();
+		published.fetch_add(1, std::memory_order_relaxed);
+
+		uint32_t previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+		if (previous & FRESH) skipped.fetch_add(1, std::memory_order_relaxed);
+		back = previous & SLOT_MASK;
+
+		wake();
+	}
+
+	// Blocks until every published frame has been shown or skipped.
+	void flush() {
+		while (shownFrames() + skippedFrames() < published.load(std::memory_order_acquire)) {
+			#ifdef AURORA_SIM
+			std::this_thread::yield();
+			#else
+			vTaskDelay(1);
+			#endif
+		}
+	}
+
+	uint32_t shownFrames() const { return shownCount.load(std::memory_order_acquire); }
+	uint32_t skippedFrames() const { return skipped.load(std::memory_order_acquire); }
+	uint32_t lastShowUs() const { return showUs.load(std::memory_order_relaxed); }
+
+  private:
+
+	static const uint32_t FRESH = 4;        // set in `middle` until the output side takes it
+	static const uint32_t SLOT_MASK = 3;
+
+	CRGB slots[3][N];
+	uint8_t brightness[3] = {0};
+	uint32_t back = 0;                       // renderer side only
+	uint32_t front = 1;                      // output side only
+	std::atomic<uint32_t> middle{2};
+	std::atomic<uint32_t> published{0};
+	std::atomic<uint32_t> shownCount{0};
+	std::atomic<uint32_t> skipped{0};
+	std::atomic<uint32_t> showUs{0};        // duration of the latest FastLED.show()
+
+	// Takes the newest finished frame, if there is one the output side hasn't shown yet.
+	bool acquire() {
+		// only acquire() clears FRESH, so a fresh frame can't disappear between the two
+		if (!(middle.load(std::memory_order_acquire) & FRESH)) return false;
+		front = middle.exchange(front, std::memory_order_acq_rel) & SLOT_MASK;
+		return true;
+	}
+
+	void drain() {
+		while (acquire()) {
+			memcpy(shown, slots[front], sizeof(shown));
+			uint32_t start = ESP.getCycleCount();
+			FastLED.show(brightness[front]);
+			showUs.store((ESP.getCycleCount() - start) / ESP.getCpuFreqMHz(), std::memory_order_relaxed);
+			shownCount.fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	#ifdef AURORA_SIM
+
+	std::thread worker;
+	std::mutex wakeMutex;
+	std::condition_variable wakeSignal;
+	bool stopping = false;
+
+	void wake() {
+		if (!worker.joinable()) {
+			drain();   // inline: show before publish() returns
+			return;
+		}
+		// the mutex only parks the idle thread; the slot swap itself stays lock-free
+		{ std::lock_guard<std::mutex> lock(wakeMutex); }
+		wakeSignal.notify_one();
+	}
+
+	void outputLoop() {
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		while (!stopping) {
+			wakeSignal.wait(lock, [this] {
+				return stopping || (middle.load(std::memory_order_acquire) & FRESH);
+			});
+			lock.unlock();
+			drain();
+			lock.lock();
+		}
+	}
+
+	void end() {
+		if (!worker.joinable()) return;
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			stopping = true;
+		}
+		wakeSignal.notify_one();
+		worker.join();
+	}
+
+	#else
+
+	TaskHandle_t task = nullptr;
+
+	void wake() {
+		if (task) xTaskNotifyGive(task);
+		else drain();   // before begin(): show from the caller
+	}
+
+	static void outputTask(void* arg) {
+		RenderPipeline* self = static_cast<RenderPipeline*>(arg);
+		for (;;) {
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			self->drain();
+		}
+	}
+
+	void end() {}
+
+	#endif
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+
+#ifdef AURORA_SIM
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+// Worker pool ******************************************************************
+// run() splits [0, count) into one contiguous range per worker, runs them
+// side by side and returns when all are done. The calling task always takes
+// the first range itself, so a pool of one is a plain function call.
+//
+// On the ESP32-S3 the helpers are FreeRTOS tasks pinned to the core loop()
+// isn't on, i.e. begin(2) renders on both cores. The host build uses
+// std::threads and begin(0) picks one worker per hardware thread.
+
+#define WORKER_POOL_MAX 16
+#define WORKER_TASK_PRIORITY 1
+#define WORKER_TASK_STACK 4096
+
+class WorkerPool {
+
+  public:
+
+	typedef void (*Job)(void* ctx, int begin, int end);
+
+	~WorkerPool() { end(); }
+
+	// Total workers including the caller; 0 = one per core.
+	void begin(uint8_t workers) {
+		end();
+		#ifdef AURORA_SIM
+		if (workers == 0) workers = (uint8_t)std::min(std::max(1u, std::thread::hardware_concurrency()), 255u);
+		#else
+		if (workers == 0) workers = portNUM_PROCESSORS;
+		#endif
+		workerCount = std::min<uint8_t>(workers, WORKER_POOL_MAX);
+
+		for (uint8_t w = 1; w < workerCount; w++) {
+			#ifdef AURORA_SIM
+			helpers[w] = std::thread([this, w, seen = generation] { helperLoop(w, seen); });
+			#else
+			// the caller is loop() on ARDUINO_RUNNING_CORE; helpers go to the other one(s)
+			BaseType_t core = (ARDUINO_RUNNING_CORE + w) % portNUM_PROCESSORS;
+			args[w] = {this, w};
+			xTaskCreatePinnedToCore(helperTask, "renderWorker", WORKER_TASK_STACK, &args[w],
+									WORKER_TASK_PRIORITY, &helpers[w], core);
+			#endif
+		}
+	}
+
+	uint8_t size() const { return workerCount; }
+
+	void run(int count, Job job, void* ctx) {
+		int parts = std::min<int>(workerCount, count);
+		if (parts <= 1) {
+			job(ctx, 0, count);
+			return;
+		}
+
+		#ifdef AURORA_SIM
+		// under the lock with generation: a helper that sat out the last batch
+		// may still be waking, and must see this batch's parts with its generation
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			current = {job, ctx, count, parts};
+			pending.store(parts - 1, std::memory_order_relaxed);
+			generation++;
+		}
+		wakeSignal.notify_all();
+		#else
+		current = {job, ctx, count, parts};
+		pending.store(parts - 1, std::memory_order_relaxed);
+		caller = xTaskGetCurrentTaskHandle();
+		for (int w = 1; w < parts; w++) xTaskNotifyGive(helpers[w]);
+		#endif
+
+		runPart(0);
+
+		#ifdef AURORA_SIM
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		doneSignal.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+		#else
+		while (pending.load(std::memory_order_acquire) != 0) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		#endif
+	}
+
+  private:
+
+	struct Batch {
+		Job job = nullptr;
+		void* ctx = nullptr;
+		int count = 0;
+		int parts = 0;
+	};
+
+	Batch current;
+	std::atomic<int> pending{0};
+	uint8_t workerCount = 1;
+
+	void runPart(int part) {
+		int begin = (int)((int64_t)current.count * part / current.parts);
+		int end = (int)((int64_t)current.count * (part + 1) / current.parts);
+		if (begin < end) current.job(current.ctx, begin, end);
+	}
+
+	#ifdef AURORA_SIM
+
+	std::thread helpers[WORKER_POOL_MAX];
+	std::mutex wakeMutex;
+	std::condition_variable wakeSignal, doneSignal;
+	uint32_t generation = 0;
+	bool stopping = false;
+
+	// `seen` is the generation at spawn, so a batch started before the thread runs isn't missed
+	void helperLoop(int w, uint32_t seen) {
+		std::unique_lock<std::mutex> lock(wakeMutex);
+		for (;;) {
+			wakeSignal.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) return;
+			seen = generation;
+			bool mine = w < current.parts;
+			lock.unlock();
+			if (mine) finishPart(w);
+			lock.lock();
+		}
+	}
+
+	void finishPart(int w) {
+		runPart(w);
+		if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			{ std::lock_guard<std::mutex> lock(wakeMutex); }
+			doneSignal.notify_one();
+		}
+	}
+
+	void end() {
+		{
+			std::lock_guard<std::mutex> lock(wakeMutex);
+			stopping = true;
+		}
+		wakeSignal.notify_all();
+		for (uint8_t w = 1; w < workerCount; w++) {
+			if (helpers[w].joinable()) helpers[w].join();
+		}
+		stopping = false;
+		workerCount = 1;
+	}
+
+	#else
+
+	struct HelperArg {
+		WorkerPool* pool;
+		int index;
+	};
+
+	TaskHandle_t helpers[WORKER_POOL_MAX] = {nullptr};
+	HelperArg args[WORKER_POOL_MAX];
+	TaskHandle_t caller = nullptr;
+
+	static void helperTask(void* arg) {
+		WorkerPool* self = static_cast<HelperArg*>(arg)->pool;
+		const int w = static_cast<HelperArg*>(arg)->index;
+		for (;;) {
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			self->runPart(w);
+			if (self->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) xTaskNotifyGive(self->caller);
+		}
+	}
+
+	void end() {
+		for (uint8_t w = 1; w < workerCount; w++) {
+			if (helpers[w]) vTaskDelete(helpers[w]);
+			helpers[w] = nullptr;
+		}
+		workerCount = 1;
+	}
+
+	#endif
+};